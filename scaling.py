@@ -0,0 +1,273 @@
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+import time
+from pathlib import Path
+from statistics import median
+from typing import List, Dict, Tuple
+
+
+def parse_arguments() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(
+        description="Scaling benchmark: generated instance sizes x thread counts."
+    )
+
+    parser.add_argument(
+        "-s",
+        "--sizes",
+        type=str,
+        help="Comma-separated JOBSxMACHINES sizes to generate",
+        default="100x20,1000x50,10000x100",
+    )
+
+    parser.add_argument(
+        "-t",
+        "--threads",
+        type=str,
+        help="Thread configuration: single number 4, comma-separated 2,4,8, or range 1:8",
+        default="1,2,4,8,16,32",
+    )
+
+    parser.add_argument(
+        "-n",
+        "--num",
+        type=int,
+        default=3,
+        help="Number of executions per size per configuration (default: 3)",
+    )
+
+    parser.add_argument(
+        "--flow-shop",
+        action="store_true",
+        help="Generate permutation flow shops instead of job shops",
+    )
+
+    parser.add_argument(
+        "--solver-args",
+        type=str,
+        default="",
+        help="Extra solver options for every run, e.g. '-r 100 --tabu 1000'",
+    )
+
+    parser.add_argument(
+        "--output",
+        type=str,
+        default="scaling_results.csv",
+        help="CSV file for the per-run records (default: scaling_results.csv)",
+    )
+
+    args = parser.parse_args()
+
+    if args.num <= 0:
+        parser.error("Number of executions must be a positive integer")
+
+    return args
+
+
+def parse_thread_config(thread_str: str) -> List[int]:
+    if not thread_str:
+        return []
+
+    threads = []
+
+    if "," in thread_str:
+        for part in thread_str.split(","):
+            threads.extend(parse_thread_config(part.strip()))
+    elif ":" in thread_str:
+        start, end = map(int, thread_str.split(":"))
+        threads.extend(range(start, end + 1))
+    else:
+        threads.append(int(thread_str))
+
+    return sorted(list(set(threads)))
+
+
+def parse_sizes(size_str: str) -> List[Tuple[int, int]]:
+    sizes = []
+    for part in size_str.split(","):
+        match = re.fullmatch(r"\s*(\d+)[xX](\d+)\s*", part)
+        if not match:
+            print(f"Error: Invalid size '{part}' (expected JOBSxMACHINES)", file=sys.stderr)
+            sys.exit(1)
+        sizes.append((int(match.group(1)), int(match.group(2))))
+    return sizes
+
+
+def generate_instance(jobs: int, machines: int, flow_shop: bool) -> str:
+    # Binary instances load without parsing, so large sizes time the solver only
+    Path("scaling").mkdir(exist_ok=True)
+    kind = "fs" if flow_shop else "js"
+    path = f"scaling/{kind}_{jobs}x{machines}.jssb"
+    if not os.path.isfile(path):
+        cmd = ["bin/main", "--generate", f"{jobs}x{machines}", "-o", path]
+        if flow_shop:
+            cmd.append("--flow-shop")
+        subprocess.run(cmd, check=True)
+    return path
+
+
+def run_command(cmd: List[str]) -> Dict:
+    # wait4 reports the child's own peak resident set, unlike RUSAGE_CHILDREN,
+    # which keeps the maximum over every child so far
+    start_time = time.perf_counter()
+    process = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = process.stdout.read().decode()
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start_time
+    process.stdout.close()
+    process.returncode = os.waitstatus_to_exitcode(status)
+
+    if process.returncode != 0:
+        print(f"Error: '{' '.join(cmd)}' failed with:\n{output.strip()}", file=sys.stderr)
+        sys.exit(1)
+
+    solved = re.search(r"Solved in:\s+([\d.]+)s", output)
+    makespan = re.search(r"Makespan:\s+(\d+)", output)
+    return {
+        "wall_seconds": elapsed,
+        "solve_seconds": float(solved.group(1)) if solved else None,
+        "max_rss_kib": usage.ru_maxrss,
+        "makespan": int(makespan.group(1)) if makespan else None,
+    }
+
+
+def run_scaling(args: argparse.Namespace, sizes: List[Tuple[int, int]], thread_counts: List[int]) -> List[Dict]:
+    configs = [("sequential", 1)] + [("parallel", tc) for tc in thread_counts]
+    extra = args.solver_args.split()
+
+    print("=" * 50)
+    print("Scaling Benchmark Configuration")
+    print("=" * 50)
+    print(f"Sizes: {', '.join(f'{j}x{m}' for j, m in sizes)}")
+    print(f"Configurations: {len(configs)}")
+    print(f"Executions per size per config: {args.num}")
+    print("=" * 50)
+
+    records = []
+    for jobs, machines in sizes:
+        path = generate_instance(jobs, machines, args.flow_shop)
+        for mode, thread_count in configs:
+            config_name = "seq" if mode == "sequential" else f"p{thread_count}"
+            if mode == "sequential":
+                cmd = ["bin/main", "-s", "-f", path] + extra
+            else:
+                cmd = ["bin/main", "-p", "-t", str(thread_count), "-f", path] + extra
+
+            for execution in range(args.num):
+                print(
+                    f"\rSize: {jobs}x{machines} | Config: {config_name} | Execution: {execution + 1}/{args.num}   ",
+                    end="",
+                    flush=True,
+                )
+                record = run_command(cmd)
+                record.update(
+                    {
+                        "jobs": jobs,
+                        "machines": machines,
+                        "operations": jobs * machines,
+                        "config": config_name,
+                        "threads": thread_count,
+                        "run": execution,
+                    }
+                )
+                records.append(record)
+    print("\n")
+    return records
+
+
+def write_csv(records: List[Dict], filename: str):
+    fields = [
+        "jobs",
+        "machines",
+        "operations",
+        "config",
+        "threads",
+        "run",
+        "wall_seconds",
+        "solve_seconds",
+        "max_rss_kib",
+        "makespan",
+    ]
+    with open(filename, "w", newline="") as file:
+        writer = csv.DictWriter(file, fieldnames=fields)
+        writer.writeheader()
+        for record in records:
+            writer.writerow({field: record[field] for field in fields})
+    print(f"Results saved as '{filename}'")
+
+
+def summarize(records: List[Dict]) -> Dict:
+    groups = {}
+    for record in records:
+        key = (record["operations"], record["jobs"], record["machines"], record["config"], record["threads"])
+        groups.setdefault(key, []).append(record)
+
+    summary = {}
+    print(f"{'Size':>12} {'Config':>6} {'Solve (s)':>12} {'Wall (s)':>10} {'Peak RSS (MiB)':>15} {'Makespan':>10}")
+    for key in sorted(groups):
+        runs = groups[key]
+        operations, jobs, machines, config, threads = key
+        solve = median(r["solve_seconds"] for r in runs)
+        wall = median(r["wall_seconds"] for r in runs)
+        rss = max(r["max_rss_kib"] for r in runs) / 1024
+        makespan = min(r["makespan"] for r in runs)
+        summary[key] = (solve, rss)
+        print(f"{f'{jobs}x{machines}':>12} {config:>6} {solve:>12.6f} {wall:>10.3f} {rss:>15.1f} {makespan:>10}")
+    return summary
+
+
+def plot_results(summary: Dict):
+    try:
+        import matplotlib.pyplot as plt
+
+        configs = sorted({key[3:] for key in summary}, key=lambda c: c[1] if c[0] != "seq" else 0)
+        plt.figure(figsize=(12, 10))
+
+        for index, (title, column, label) in enumerate(
+            [("Solve Time", 0, "Time (seconds)"), ("Peak Memory", 1, "Resident set (MiB)")]
+        ):
+            plt.subplot(2, 1, index + 1)
+            for config, threads in configs:
+                points = sorted((key[0], value[column]) for key, value in summary.items() if key[3] == config)
+                plt.loglog(
+                    [p[0] for p in points],
+                    [p[1] for p in points],
+                    marker="o",
+                    label=config.upper(),
+                )
+            plt.title(title, fontsize=14, fontweight="bold")
+            plt.xlabel("Operations", fontsize=12)
+            plt.ylabel(label, fontsize=12)
+            plt.grid(alpha=0.3, which="both")
+            plt.legend()
+
+        plt.suptitle("Scaling Results", fontsize=16, fontweight="bold")
+        plt.tight_layout()
+        plt.savefig("scaling_results.png", dpi=300, bbox_inches="tight")
+        print("Plot saved as 'scaling_results.png'")
+
+    except ImportError:
+        print("Matplotlib not available. Install with: pip install matplotlib")
+    except Exception as e:
+        print(f"Error creating plot: {e}")
+
+
+def main():
+    try:
+        args = parse_arguments()
+        sizes = parse_sizes(args.sizes)
+        thread_counts = parse_thread_config(args.threads)
+        records = run_scaling(args, sizes, thread_counts)
+        write_csv(records, args.output)
+        summary = summarize(records)
+        plot_results(summary)
+    except KeyboardInterrupt:
+        print("\nBenchmark interrupted by user", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
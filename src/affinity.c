@@ -0,0 +1,212 @@
+#define _GNU_SOURCE
+#include "affinity.h"
+#include "jobshop.h"
+#include <omp.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Allowed CPUs grouped by NUMA node, read once from sysfs. Nodes are numbered
+// densely in sysfs order; without node information all CPUs are node 0.
+typedef struct {
+    int loaded;
+    int num_nodes;
+    int num_cpus;
+    int node_offsets[AFFINITY_MAX_NODES + 1]; // CPUs of node i are cpus[node_offsets[i]..node_offsets[i + 1])
+    int cpus[CPU_SETSIZE];
+    int cpu_node[CPU_SETSIZE];
+} topology_t;
+
+static topology_t topology;
+
+// Per-node copies of one instance, each allocated and first touched by a
+// thread running on its node. Read-only once built.
+static struct {
+    const jobshop_t* master;
+    jobshop_t* copies[AFFINITY_MAX_NODES];
+} replicas;
+
+int affinity_policy_from_name(const char* name, pin_policy_t* policy) {
+    if (strcmp(name, "compact") == 0) {
+        *policy = PIN_COMPACT;
+    } else if (strcmp(name, "scatter") == 0) {
+        *policy = PIN_SCATTER;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+// Parses a sysfs CPU list such as "0-3,8-11"; -1 when the node does not exist
+static int affinity_read_cpulist(int node, cpu_set_t* set) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    CPU_ZERO(set);
+    char line[4096];
+    if (fgets(line, sizeof(line), file)) {
+        char* cursor = line;
+        while (*cursor && *cursor != '\n') {
+            char* end;
+            long first = strtol(cursor, &end, 10);
+            if (end == cursor) {
+                break;
+            }
+            long last = first;
+            if (*end == '-') {
+                cursor = end + 1;
+                last = strtol(cursor, &end, 10);
+            }
+            for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+                CPU_SET(cpu, set);
+            }
+            cursor = *end == ',' ? end + 1 : end;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+static void affinity_load_topology(void) {
+    if (topology.loaded) {
+        return;
+    }
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0) {
+        CPU_ZERO(&allowed);
+        CPU_SET(0, &allowed);
+    }
+
+    // Nodes without allowed CPUs (memory-only, or outside our cpuset) are skipped
+    for (int node = 0; node < AFFINITY_MAX_NODES; node++) {
+        cpu_set_t set;
+        if (affinity_read_cpulist(node, &set) < 0) {
+            continue;
+        }
+        CPU_AND(&set, &set, &allowed);
+        if (CPU_COUNT(&set) == 0) {
+            continue;
+        }
+        topology.node_offsets[topology.num_nodes] = topology.num_cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                topology.cpus[topology.num_cpus++] = cpu;
+                topology.cpu_node[cpu] = topology.num_nodes;
+            }
+        }
+        topology.num_nodes++;
+    }
+    if (topology.num_nodes == 0) {
+        topology.num_nodes = 1;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                topology.cpus[topology.num_cpus++] = cpu;
+            }
+        }
+    }
+    topology.node_offsets[topology.num_nodes] = topology.num_cpus;
+    topology.loaded = 1;
+}
+
+// Binds each thread of a team of num_threads to one CPU. libgomp keeps its
+// pool between regions, so later teams of up to num_threads run on the same
+// threads and keep their placement.
+int affinity_pin_threads(pin_policy_t policy, int num_threads) {
+    if (policy == PIN_NONE) {
+        return 0;
+    }
+    affinity_load_topology();
+
+    int failed = 0;
+#pragma omp parallel num_threads(num_threads) reduction(| : failed)
+    {
+        int thread = omp_get_thread_num();
+        int cpu;
+        if (policy == PIN_COMPACT) {
+            cpu = topology.cpus[thread % topology.num_cpus];
+        } else {
+            int node = thread % topology.num_nodes;
+            int size = topology.node_offsets[node + 1] - topology.node_offsets[node];
+            cpu = topology.cpus[topology.node_offsets[node] + (thread / topology.num_nodes) % size];
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        failed = sched_setaffinity(0, sizeof(set), &set) < 0;
+    }
+    if (failed) {
+        fprintf(stderr, "Error: Cannot pin threads to CPUs\n");
+        return -1;
+    }
+    return 0;
+}
+
+// One block per copy: the header, then offsets, machines, times and remaining work
+static jobshop_t* affinity_copy_instance(const jobshop_t* jss) {
+    size_t n = (size_t)jss->num_operations;
+    jobshop_t* copy = malloc(sizeof(jobshop_t) + ((size_t)jss->num_jobs + 1 + 3 * n) * sizeof(int));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *jss;
+    copy->job_offsets = (int*)(copy + 1);
+    copy->machines = copy->job_offsets + jss->num_jobs + 1;
+    copy->times = copy->machines + n;
+    copy->remaining_work = copy->times + n;
+    memcpy(copy->job_offsets, jss->job_offsets, ((size_t)jss->num_jobs + 1) * sizeof(int));
+    memcpy(copy->machines, jss->machines, n * sizeof(int));
+    memcpy(copy->times, jss->times, n * sizeof(int));
+    memcpy(copy->remaining_work, jss->remaining_work, n * sizeof(int));
+    return copy;
+}
+
+// The first thread of the team to run on each node copies the instance there.
+// Nothing is copied on a single node.
+int affinity_replicate_instance(const jobshop_t* jss, int num_threads) {
+    affinity_load_topology();
+    if (topology.num_nodes <= 1) {
+        return 0;
+    }
+
+    int claimed[AFFINITY_MAX_NODES] = { 0 };
+    int failed = 0;
+#pragma omp parallel num_threads(num_threads) reduction(| : failed)
+    {
+        int cpu = sched_getcpu();
+        int node = cpu >= 0 && cpu < CPU_SETSIZE ? topology.cpu_node[cpu] : 0;
+        if (__atomic_exchange_n(&claimed[node], 1, __ATOMIC_ACQ_REL) == 0) {
+            replicas.copies[node] = affinity_copy_instance(jss);
+            failed = !replicas.copies[node];
+        }
+    }
+    replicas.master = jss;
+    if (failed) {
+        fprintf(stderr, "Error: Out of memory replicating the instance\n");
+        affinity_release_replicas();
+        return -1;
+    }
+    return 0;
+}
+
+// The copy on the calling thread's node, or jss itself when it has none.
+// Solutions keep pointing into the master, so decode with jss.
+const jobshop_t* affinity_local_instance(const jobshop_t* jss) {
+    if (jss != replicas.master) {
+        return jss;
+    }
+    int cpu = sched_getcpu();
+    const jobshop_t* copy = cpu >= 0 && cpu < CPU_SETSIZE ? replicas.copies[topology.cpu_node[cpu]] : NULL;
+    return copy ? copy : jss;
+}
+
+void affinity_release_replicas(void) {
+    for (int node = 0; node < AFFINITY_MAX_NODES; node++) {
+        free(replicas.copies[node]);
+        replicas.copies[node] = NULL;
+    }
+    replicas.master = NULL;
+}
@@ -0,0 +1,22 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include "jobshop.h"
+
+#define AFFINITY_MAX_NODES 64
+
+// Thread placement for --pin: compact fills one NUMA node's CPUs before the
+// next, scatter deals threads round-robin over the nodes
+typedef enum {
+    PIN_NONE = 0,
+    PIN_COMPACT,
+    PIN_SCATTER
+} pin_policy_t;
+
+int affinity_policy_from_name(const char* name, pin_policy_t* policy);
+int affinity_pin_threads(pin_policy_t policy, int num_threads);
+int affinity_replicate_instance(const jobshop_t* jss, int num_threads);
+const jobshop_t* affinity_local_instance(const jobshop_t* jss);
+void affinity_release_replicas(void);
+
+#endif
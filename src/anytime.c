@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#include "anytime.h"
+#include <limits.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+static volatile sig_atomic_t anytime_interrupted = 0;
+
+static void anytime_handle_signal(int signum) {
+    (void)signum;
+    anytime_interrupted = 1;
+}
+
+static double anytime_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void anytime_init(anytime_t* anytime, double time_limit, FILE* progress) {
+    anytime->start = anytime_now();
+    anytime->deadline = time_limit > 0.0 ? anytime->start + time_limit : 0.0;
+    anytime->cancelled = 0;
+    anytime->incumbent = INT_MAX;
+    anytime->lower_bound = 0;
+    anytime->optimal = 0;
+    anytime->progress = progress;
+}
+
+// Ctrl-C cancels like a deadline; a second one falls back to the default action
+void anytime_install_interrupt(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = anytime_handle_signal;
+    action.sa_flags = SA_RESETHAND;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+}
+
+// Flag read only, for the innermost polling points
+int anytime_cancelled(const anytime_t* anytime) {
+    if (!anytime) {
+        return 0;
+    }
+    int cancelled;
+#pragma omp atomic read
+    cancelled = anytime->cancelled;
+    return cancelled;
+}
+
+// Reads the clock (a vDSO call, tens of nanoseconds) and latches cancellation
+int anytime_expired(anytime_t* anytime) {
+    if (!anytime) {
+        return 0;
+    }
+    if (anytime_cancelled(anytime)) {
+        return 1;
+    }
+    if (anytime_interrupted || (anytime->deadline > 0.0 && anytime_now() >= anytime->deadline)) {
+#pragma omp atomic write
+        anytime->cancelled = 1;
+        return 1;
+    }
+    return 0;
+}
+
+void anytime_set_lower_bound(anytime_t* anytime, int lower_bound) {
+    if (anytime) {
+        anytime->lower_bound = lower_bound;
+    }
+}
+
+int anytime_optimal(const anytime_t* anytime) {
+    if (!anytime) {
+        return 0;
+    }
+    int optimal;
+#pragma omp atomic read
+    optimal = anytime->optimal;
+    return optimal;
+}
+
+// Improvements are rare, so a critical section keeps the check, the update and
+// the progress line consistent without slowing any hot loop
+void anytime_publish(anytime_t* anytime, int makespan, const char* phase) {
+    if (!anytime) {
+        return;
+    }
+    int incumbent;
+#pragma omp atomic read
+    incumbent = anytime->incumbent;
+    if (makespan >= incumbent) {
+        return;
+    }
+#pragma omp critical(anytime_incumbent)
+    {
+        if (makespan < anytime->incumbent) {
+#pragma omp atomic write
+            anytime->incumbent = makespan;
+            if (anytime->progress) {
+                fprintf(anytime->progress, "Progress:\t %.6fs\t %d\t %s\n", anytime_elapsed(anytime), makespan, phase);
+                fflush(anytime->progress);
+            }
+            // Nothing can beat a schedule that meets the lower bound, every phase may stop
+            if (anytime->lower_bound > 0 && makespan <= anytime->lower_bound) {
+#pragma omp atomic write
+                anytime->optimal = 1;
+#pragma omp atomic write
+                anytime->cancelled = 1;
+            }
+        }
+    }
+}
+
+double anytime_elapsed(const anytime_t* anytime) {
+    return anytime_now() - anytime->start;
+}
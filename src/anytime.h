@@ -0,0 +1,30 @@
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+#include <stdio.h>
+
+// Shared solve budget and incumbent for one instance. Every phase polls
+// anytime_expired at its natural loop boundary and, once it fires, returns
+// the best schedule it holds, so a solve ends within one iteration of the
+// deadline and always with a valid schedule. All functions accept NULL,
+// meaning no budget and no reporting.
+typedef struct {
+    double start; // Monotonic seconds
+    double deadline; // 0 when unlimited
+    int cancelled; // Sticky once the deadline passes or SIGINT arrives
+    int incumbent; // Best makespan published by any phase or thread
+    int lower_bound; // An incumbent at or below it is optimal and cancels, 0 when unknown
+    int optimal; // Set when the incumbent reached lower_bound
+    FILE* progress; // Time-to-incumbent lines, NULL for silence
+} anytime_t;
+
+void anytime_init(anytime_t* anytime, double time_limit, FILE* progress);
+void anytime_install_interrupt(void);
+int anytime_expired(anytime_t* anytime);
+int anytime_cancelled(const anytime_t* anytime);
+void anytime_set_lower_bound(anytime_t* anytime, int lower_bound);
+int anytime_optimal(const anytime_t* anytime);
+void anytime_publish(anytime_t* anytime, int makespan, const char* phase);
+double anytime_elapsed(const anytime_t* anytime);
+
+#endif
@@ -0,0 +1,101 @@
+#define _POSIX_C_SOURCE 200809L
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Block header is padded so the first allocation is cache-line aligned
+#define ARENA_HEADER_SIZE ((sizeof(arena_block_t) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static size_t align_up(size_t value) {
+    return (value + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+void arena_init(arena_t* arena, size_t block_size) {
+    arena->head = NULL;
+    arena->mappings = NULL;
+    arena->block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+    size = align_up(size > 0 ? size : 1);
+
+    arena_block_t* block = arena->head;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > arena->block_size ? size : arena->block_size;
+        void* memory = NULL;
+        if (posix_memalign(&memory, ARENA_ALIGNMENT, ARENA_HEADER_SIZE + capacity) != 0) {
+            return NULL;
+        }
+        block = memory;
+        block->next = arena->head;
+        block->capacity = capacity;
+        block->used = 0;
+        arena->head = block;
+    }
+
+    void* ptr = (char*)block + ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+    return ptr;
+}
+
+void* arena_calloc(arena_t* arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void* ptr = arena_alloc(arena, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+// The arena unmaps the region on reset or destroy, so zero-copy data can
+// live exactly as long as everything else allocated for the instance
+int arena_adopt_mapping(arena_t* arena, void* address, size_t length) {
+    arena_mapping_t* mapping = arena_alloc(arena, sizeof(arena_mapping_t));
+    if (!mapping) {
+        return -1;
+    }
+    mapping->address = address;
+    mapping->length = length;
+    mapping->next = arena->mappings;
+    arena->mappings = mapping;
+    return 0;
+}
+
+static void arena_unmap(arena_t* arena) {
+    for (arena_mapping_t* mapping = arena->mappings; mapping; mapping = mapping->next) {
+        munmap(mapping->address, mapping->length);
+    }
+    arena->mappings = NULL;
+}
+
+void arena_reset(arena_t* arena) {
+    arena_unmap(arena);
+    // Keep the most recent block around for reuse, release the rest
+    arena_block_t* block = arena->head;
+    if (!block) {
+        return;
+    }
+    arena_block_t* next = block->next;
+    while (next) {
+        arena_block_t* tmp = next->next;
+        free(next);
+        next = tmp;
+    }
+    block->next = NULL;
+    block->used = 0;
+}
+
+void arena_destroy(arena_t* arena) {
+    arena_unmap(arena);
+    arena_block_t* block = arena->head;
+    while (block) {
+        arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
@@ -0,0 +1,36 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 64
+#define ARENA_DEFAULT_BLOCK_SIZE (1 << 20)
+
+typedef struct arena_block {
+    struct arena_block* next;
+    size_t capacity;
+    size_t used;
+} arena_block_t;
+
+// Read-only file mapping whose lifetime is tied to the arena
+typedef struct arena_mapping {
+    struct arena_mapping* next;
+    void* address;
+    size_t length;
+} arena_mapping_t;
+
+// Bump allocator: allocations are freed all at once by arena_reset/arena_destroy
+typedef struct {
+    arena_block_t* head;
+    size_t block_size;
+    arena_mapping_t* mappings;
+} arena_t;
+
+void arena_init(arena_t* arena, size_t block_size);
+void* arena_alloc(arena_t* arena, size_t size);
+void* arena_calloc(arena_t* arena, size_t count, size_t size);
+int arena_adopt_mapping(arena_t* arena, void* address, size_t length);
+void arena_reset(arena_t* arena);
+void arena_destroy(arena_t* arena);
+
+#endif
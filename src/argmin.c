@@ -0,0 +1,95 @@
+#include "argmin.h"
+#include <stddef.h>
+
+static int argmin_scalar(const int* values, int n) {
+    int best = 0;
+    for (int i = 1; i < n; i++) {
+        if (values[i] < values[best]) {
+            best = i;
+        }
+    }
+    return values[best] == ARGMIN_EMPTY ? -1 : best;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// Both kernels reduce to the minimum first, then return the first lane equal
+// to it, which gives the same tie-breaking as the scalar loop
+
+__attribute__((target("sse4.1"))) static int argmin_sse41(const int* values, int n) {
+    __m128i low = _mm_loadu_si128((const __m128i*)values);
+    __m128i high = _mm_loadu_si128((const __m128i*)(values + 4));
+    for (int i = ARGMIN_LANE_WIDTH; i < n; i += ARGMIN_LANE_WIDTH) {
+        low = _mm_min_epi32(low, _mm_loadu_si128((const __m128i*)(values + i)));
+        high = _mm_min_epi32(high, _mm_loadu_si128((const __m128i*)(values + i + 4)));
+    }
+    __m128i min = _mm_min_epi32(low, high);
+    min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+    min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+    int value = _mm_cvtsi128_si32(min);
+    if (value == ARGMIN_EMPTY) {
+        return -1;
+    }
+
+    for (int i = 0; i < n; i += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values + i)), min);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+        if (mask) {
+            return i + __builtin_ctz((unsigned)mask);
+        }
+    }
+    return -1;
+}
+
+__attribute__((target("avx2"))) static int argmin_avx2(const int* values, int n) {
+    __m256i min = _mm256_loadu_si256((const __m256i*)values);
+    for (int i = ARGMIN_LANE_WIDTH; i < n; i += ARGMIN_LANE_WIDTH) {
+        min = _mm256_min_epi32(min, _mm256_loadu_si256((const __m256i*)(values + i)));
+    }
+    __m128i half = _mm_min_epi32(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int value = _mm_cvtsi128_si32(half);
+    if (value == ARGMIN_EMPTY) {
+        return -1;
+    }
+
+    __m256i target = _mm256_set1_epi32(value);
+    for (int i = 0; i < n; i += ARGMIN_LANE_WIDTH) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values + i)), target);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask) {
+            return i + __builtin_ctz((unsigned)mask);
+        }
+    }
+    return -1;
+}
+#endif
+
+typedef int (*argmin_kernel_t)(const int*, int);
+
+static argmin_kernel_t argmin_kernel = argmin_scalar;
+static const char* argmin_name = "scalar";
+
+// Resolved once at load time, before any solver thread exists
+__attribute__((constructor)) static void argmin_resolve(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        argmin_kernel = argmin_avx2;
+        argmin_name = "avx2";
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        argmin_kernel = argmin_sse41;
+        argmin_name = "sse4.1";
+    }
+#endif
+}
+
+int argmin_i32(const int* values, int n) {
+    return argmin_kernel(values, n);
+}
+
+const char* argmin_kernel_name(void) {
+    return argmin_name;
+}
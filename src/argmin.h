@@ -0,0 +1,19 @@
+#ifndef ARGMIN_H
+#define ARGMIN_H
+
+// Lanes are padded to a multiple of this with ARGMIN_EMPTY so the vector
+// kernels never need a scalar tail
+#define ARGMIN_LANE_WIDTH 8
+#define ARGMIN_EMPTY 0x7fffffff
+
+// Index of the smallest value, ties to the lowest index. n must be a positive
+// multiple of ARGMIN_LANE_WIDTH; returns -1 when every lane is ARGMIN_EMPTY.
+// Dispatches once at runtime to AVX2, SSE4.1 or a scalar loop.
+int argmin_i32(const int* values, int n);
+const char* argmin_kernel_name(void);
+
+static inline int argmin_padded_length(int n) {
+    return (n + ARGMIN_LANE_WIDTH - 1) / ARGMIN_LANE_WIDTH * ARGMIN_LANE_WIDTH;
+}
+
+#endif
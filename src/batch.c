@@ -0,0 +1,328 @@
+#define _POSIX_C_SOURCE 200809L
+#include "batch.h"
+#include "anytime.h"
+#include "arena.h"
+#include "bounds.h"
+#include "dispatch.h"
+#include "exact.h"
+#include "flowshop.h"
+#include "genetic.h"
+#include "grasp.h"
+#include "jobshop.h"
+#include "tabu.h"
+#include "utils.h"
+#include <glob.h>
+#include <limits.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GRASP_TASK_CHUNK 64 // Minimum restarts per task, amortizes worker setup
+#define GRASP_TASKS_PER_THREAD 64 // Caps the task count for very large restart counts
+
+static int batch_push(batch_files_t* files, const char* path) {
+    if (files->count == files->capacity) {
+        int capacity = files->capacity ? 2 * files->capacity : 64;
+        char** paths = realloc(files->paths, (size_t)capacity * sizeof(char*));
+        if (!paths) {
+            return -1;
+        }
+        files->paths = paths;
+        files->capacity = capacity;
+    }
+    files->paths[files->count] = strdup(path);
+    return files->paths[files->count++] ? 0 : -1;
+}
+
+// Globs are expanded here so quoted patterns work without a shell
+int batch_add_pattern(batch_files_t* files, const char* pattern) {
+    glob_t matches;
+    if (glob(pattern, GLOB_NOCHECK, NULL, &matches) != 0) {
+        return batch_push(files, pattern);
+    }
+    for (size_t i = 0; i < matches.gl_pathc; i++) {
+        if (batch_push(files, matches.gl_pathv[i]) < 0) {
+            globfree(&matches);
+            return -1;
+        }
+    }
+    globfree(&matches);
+    return 0;
+}
+
+// One path or pattern per line, blank lines and # comments ignored
+int batch_add_list(batch_files_t* files, const char* list_file) {
+    FILE* file = fopen(list_file, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file list '%s'\n", list_file);
+        return -1;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+        if (batch_add_pattern(files, line) < 0) {
+            fclose(file);
+            return -1;
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+void batch_files_free(batch_files_t* files) {
+    for (int i = 0; i < files->count; i++) {
+        free(files->paths[i]);
+    }
+    free(files->paths);
+    files->paths = NULL;
+    files->count = files->capacity = 0;
+}
+
+// Rule pass as one task per rule on the enclosing team, into compact buffers
+static int batch_rule_pass(const jobshop_t* jss, jobshop_solution_t* solution, uint64_t seed, arena_t* arena) {
+    compact_solution_t candidates[DISPATCH_RULE_COUNT];
+    for (int i = 0; i < DISPATCH_RULE_COUNT; i++) {
+        if (compact_solution_init(&candidates[i], arena, jss) < 0) {
+            return -1;
+        }
+    }
+
+    int failed = 0;
+#pragma omp taskloop grainsize(1) shared(candidates, failed)
+    for (int i = 0; i < DISPATCH_RULE_COUNT; i++) {
+        arena_t task_arena;
+        arena_init(&task_arena, 0);
+        dispatch_scratch_t scratch;
+        if (dispatch_scratch_init(&scratch, &task_arena, jss) < 0) {
+#pragma omp atomic write
+            failed = 1;
+        } else {
+            rng_seed(&scratch.rng, seed, i);
+            dispatch_rollout(jss, &candidates[i], multi_pass_rules[i], 1, &scratch);
+        }
+        arena_destroy(&task_arena);
+    }
+
+    if (failed) {
+        return -1;
+    }
+
+    int best_idx = 0;
+    for (int i = 1; i < DISPATCH_RULE_COUNT; i++) {
+        if (candidates[i].makespan < candidates[best_idx].makespan) {
+            best_idx = i;
+        }
+    }
+    jobshop_solution_decode(solution, jss, &candidates[best_idx]);
+    return solution->makespan;
+}
+
+// GRASP restarts in chunks of tasks, merged with the same tie-breaking as solve_grasp
+static int batch_grasp(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config,
+    arena_t* arena) {
+    compact_solution_t best;
+    if (compact_solution_init(&best, arena, jss) < 0) {
+        return -1;
+    }
+    int best_restart = INT_MAX;
+    int failed = 0;
+    int chunk = max(GRASP_TASK_CHUNK, config->restarts / (omp_get_num_threads() * GRASP_TASKS_PER_THREAD));
+    int chunks = (config->restarts + chunk - 1) / chunk;
+
+#pragma omp taskloop grainsize(1) shared(best, best_restart, failed)
+    for (int c = 0; c < chunks; c++) {
+        grasp_worker_t worker;
+        if (grasp_worker_init(&worker, jss) < 0) {
+#pragma omp atomic write
+            failed = 1;
+        } else {
+            int last = (c + 1) * chunk;
+            grasp_worker_run(&worker, jss, config, c * chunk,
+                last < config->restarts ? last : config->restarts);
+#pragma omp critical(batch_grasp_best)
+            {
+                // A chunk cancelled before its first restart has no best
+                if (worker.best
+                    && (best_restart == INT_MAX || worker.best->makespan < best.makespan
+                        || (worker.best->makespan == best.makespan && worker.best_restart < best_restart))) {
+                    memcpy(best.start, worker.best->start, (size_t)jss->num_operations * sizeof(int));
+                    best.makespan = worker.best->makespan;
+                    best.rule_used = worker.best->rule_used;
+                    best_restart = worker.best_restart;
+                }
+            }
+        }
+        grasp_worker_destroy(&worker);
+    }
+
+    if (failed) {
+        return -1;
+    }
+    if (best_restart != INT_MAX && best.makespan < solution->makespan) {
+        jobshop_solution_decode(solution, jss, &best);
+    }
+    return solution->makespan;
+}
+
+static void solve_batch_instance(const char* file, const solver_config_t* config, int exact,
+    const char* output_dir, batch_result_t* result) {
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    result->file = file;
+    result->makespan = -1;
+    result->lower_bound = 0;
+    result->num_jobs = result->num_machines = 0;
+    result->rule_used = FIRST_IN_FIRST_OUT;
+
+    arena_t arena;
+    arena_init(&arena, 0);
+    jobshop_t jss;
+    jobshop_solution_t solution;
+    if (read_jobshop_from_file(file, &jss, &arena) < 0 || jobshop_solution_init(&solution, &arena, &jss) < 0) {
+        arena_destroy(&arena);
+        return;
+    }
+    result->num_jobs = jss.num_jobs;
+    result->num_machines = jss.num_machines;
+
+    lower_bound_t bound;
+    if (compute_lower_bound(&jss, 1, &bound) < 0) {
+        arena_destroy(&arena);
+        return;
+    }
+    result->lower_bound = bound.value;
+
+    // Improvement phases that are not task-based run on the calling thread only
+    // Instances share the batch deadline, each with its own silent incumbent
+    solver_config_t instance_config = *config;
+    anytime_t instance_anytime;
+    if (config->anytime) {
+        instance_anytime = *config->anytime;
+        instance_anytime.incumbent = INT_MAX;
+        instance_anytime.progress = NULL;
+        instance_anytime.optimal = 0;
+        anytime_set_lower_bound(&instance_anytime, bound.value);
+        instance_config.anytime = &instance_anytime;
+    }
+    config = &instance_config;
+
+    solver_config_t serial_config = *config;
+    serial_config.num_threads = 1;
+    serial_config.tabu_parallel = 0;
+
+    int makespan = jss.flow_shop ? solve_neh(&jss, &solution) : batch_rule_pass(&jss, &solution, config->seed, &arena);
+    if (makespan >= 0) {
+        anytime_publish(config->anytime, makespan, jss.flow_shop ? "neh" : "rules");
+    }
+    if (makespan >= 0 && jss.flow_shop && config->ig_iterations > 0) {
+        makespan = solve_iterated_greedy(&jss, &solution, &serial_config);
+    }
+    if (makespan >= 0 && config->restarts > 0) {
+        makespan = batch_grasp(&jss, &solution, config, &arena);
+    }
+    if (makespan >= 0 && config->ga_generations > 0) {
+        makespan = solve_genetic(&jss, &solution, &serial_config);
+    }
+    if (makespan >= 0 && config->tabu_iterations > 0) {
+        makespan = tabu_search(&jss, &solution, &serial_config);
+    }
+    if (makespan >= 0 && exact) {
+        exact_stats_t stats;
+        makespan = solve_exact(&jss, &solution, &serial_config, &stats);
+    }
+
+    if (makespan >= 0 && output_dir) {
+        const char* base = strrchr(file, '/');
+        base = base ? base + 1 : file;
+        size_t stem = strcspn(base, ".");
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%.*s.output", output_dir, (int)stem, base);
+        if (write_jobshop_solution_to_file(path, &solution) < 0) {
+            makespan = -1;
+        }
+    }
+
+    result->makespan = makespan;
+    result->rule_used = solution.rule_used;
+    arena_destroy(&arena);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    result->seconds = get_time_diff(start_time, end_time);
+}
+
+// Solves every file in one process. A single OpenMP team serves both levels:
+// each instance is a task, and its rule pass and restarts are nested tasks on
+// the same team, so idle threads pick up work from whichever instance has it.
+int solve_batch(const batch_files_t* files, const solver_config_t* config, int exact, const char* output_dir,
+    batch_result_t* results) {
+    int failures = 0;
+
+#pragma omp parallel num_threads(config->num_threads)
+    {
+#pragma omp single
+        {
+            for (int i = 0; i < files->count; i++) {
+#pragma omp task firstprivate(i)
+                solve_batch_instance(files->paths[i], config, exact, output_dir, &results[i]);
+            }
+        }
+    }
+
+    for (int i = 0; i < files->count; i++) {
+        failures += results[i].makespan < 0;
+    }
+    return failures;
+}
+
+int write_batch_csv(const char* filename, const batch_result_t* results, int count) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
+        return -1;
+    }
+
+    fprintf(file, "file,jobs,machines,makespan,lower_bound,gap,rule,seconds\n");
+    for (int i = 0; i < count; i++) {
+        print_csv_string(file, results[i].file);
+        fprintf(file, ",%d,%d,%d,%d,%.4f,%s,%.9f\n", results[i].num_jobs, results[i].num_machines,
+            results[i].makespan, results[i].lower_bound, lower_bound_gap(results[i].makespan, results[i].lower_bound),
+            dispatch_rule_name(results[i].rule_used), results[i].seconds);
+    }
+
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) {
+        fprintf(stderr, "Error: Cannot write file '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+int write_batch_json(const char* filename, const batch_result_t* results, int count) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
+        return -1;
+    }
+
+    fprintf(file, "[\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "  {\"file\": ");
+        print_json_string(file, results[i].file);
+        fprintf(file, ", \"jobs\": %d, \"machines\": %d, \"makespan\": %d, \"lower_bound\": %d, \"gap\": %.4f, "
+                      "\"rule\": \"%s\", \"seconds\": %.9f}%s\n",
+            results[i].num_jobs, results[i].num_machines, results[i].makespan, results[i].lower_bound,
+            lower_bound_gap(results[i].makespan, results[i].lower_bound), dispatch_rule_name(results[i].rule_used),
+            results[i].seconds, i + 1 < count ? "," : "");
+    }
+    fprintf(file, "]\n");
+
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "jobshop.h"
+
+typedef struct {
+    char** paths;
+    int count;
+    int capacity;
+} batch_files_t;
+
+typedef struct {
+    const char* file;
+    int num_jobs;
+    int num_machines;
+    int makespan; // -1 if the instance could not be read or solved
+    int lower_bound;
+    dispatch_rule_t rule_used;
+    double seconds; // Wall time from task start to finish, including waits on the shared pool
+} batch_result_t;
+
+int batch_add_pattern(batch_files_t* files, const char* pattern);
+int batch_add_list(batch_files_t* files, const char* list_file);
+void batch_files_free(batch_files_t* files);
+
+int solve_batch(const batch_files_t* files, const solver_config_t* config, int exact, const char* output_dir,
+    batch_result_t* results);
+int write_batch_csv(const char* filename, const batch_result_t* results, int count);
+int write_batch_json(const char* filename, const batch_result_t* results, int count);
+
+#endif
@@ -0,0 +1,211 @@
+#include "bench.h"
+#include "arena.h"
+#include "argmin.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include "parallel.h"
+#include "sequential.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    double min;
+    double median;
+    double p95;
+    double p99;
+    double mean;
+} bench_stats_t;
+
+typedef enum {
+    BENCH_RULE,
+    BENCH_SEQUENTIAL,
+    BENCH_PARALLEL
+} bench_kind_t;
+
+typedef struct {
+    const jobshop_t* jss;
+    const solver_config_t* config;
+    jobshop_solution_t* solution;
+    dispatch_scratch_t* scratch;
+    bench_kind_t kind;
+    dispatch_rule_t rule;
+    int num_threads;
+} bench_case_t;
+
+// Comma-separated list and a:b ranges, e.g. "1,2,4" or "1:8"
+int parse_thread_list(const char* text, bench_options_t* options) {
+    options->num_thread_counts = 0;
+    const char* c = text;
+    while (*c) {
+        char* end;
+        long first = strtol(c, &end, 10);
+        long last = first;
+        if (end == c || first <= 0) {
+            return -1;
+        }
+        if (*end == ':') {
+            c = end + 1;
+            last = strtol(c, &end, 10);
+            if (end == c || last < first) {
+                return -1;
+            }
+        }
+        for (long t = first; t <= last; t++) {
+            if (options->num_thread_counts == BENCH_MAX_THREAD_COUNTS) {
+                return -1;
+            }
+            options->thread_counts[options->num_thread_counts++] = (int)t;
+        }
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        c = end;
+    }
+    return options->num_thread_counts > 0 ? 0 : -1;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile over sorted samples
+static double percentile(const double* sorted, int count, double p) {
+    int rank = (int)(p / 100.0 * count + 0.999999);
+    rank = rank < 1 ? 1 : (rank > count ? count : rank);
+    return sorted[rank - 1];
+}
+
+static int run_case(const bench_case_t* bench) {
+    solver_config_t config = *bench->config;
+    switch (bench->kind) {
+    case BENCH_RULE:
+        rng_seed(&bench->scratch->rng, config.seed, bench->rule);
+        return solve_with_dispatch_rule(bench->jss, bench->solution, bench->rule, bench->scratch);
+    case BENCH_SEQUENTIAL:
+        bench->solution->makespan = 0;
+        return solve_sequential(bench->jss, bench->solution, &config);
+    case BENCH_PARALLEL:
+        config.num_threads = bench->num_threads;
+        bench->solution->makespan = 0;
+        return solve_parallel(bench->jss, bench->solution, &config);
+    }
+    return -1;
+}
+
+static int measure(const bench_case_t* bench, const bench_options_t* options, double* samples,
+    bench_stats_t* stats) {
+    for (int i = 0; i < options->warmup; i++) {
+        if (run_case(bench) < 0) {
+            return -1;
+        }
+    }
+
+    double total = 0.0;
+    for (int i = 0; i < options->repeats; i++) {
+        struct timespec start_time, end_time;
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        int makespan = run_case(bench);
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        if (makespan < 0) {
+            return -1;
+        }
+        samples[i] = get_time_diff(start_time, end_time);
+        total += samples[i];
+    }
+
+    qsort(samples, options->repeats, sizeof(double), compare_double);
+    stats->min = samples[0];
+    stats->median = percentile(samples, options->repeats, 50.0);
+    stats->p95 = percentile(samples, options->repeats, 95.0);
+    stats->p99 = percentile(samples, options->repeats, 99.0);
+    stats->mean = total / options->repeats;
+    return 0;
+}
+
+static void print_record(FILE* out, const char* instance, const jobshop_t* jss, const char* name, int threads,
+    const bench_options_t* options, const bench_stats_t* stats, int makespan, long ops_per_run,
+    double efficiency) {
+    fprintf(out, "{\"instance\": ");
+    print_json_string(out, instance);
+    fprintf(out,
+        ", \"jobs\": %d, \"machines\": %d, \"config\": \"%s\", \"threads\": %d, "
+        "\"warmup\": %d, \"repeats\": %d, \"min_s\": %.9f, \"median_s\": %.9f, \"p95_s\": %.9f, "
+        "\"p99_s\": %.9f, \"mean_s\": %.9f, \"makespan\": %d, \"ops_per_s\": %.1f, \"argmin\": \"%s\", ",
+        jss->num_jobs, jss->num_machines, name, threads, options->warmup, options->repeats,
+        stats->min, stats->median, stats->p95, stats->p99, stats->mean, makespan,
+        ops_per_run / stats->median, argmin_kernel_name());
+    if (efficiency >= 0.0) {
+        fprintf(out, "\"efficiency\": %.4f}\n", efficiency);
+    } else {
+        fprintf(out, "\"efficiency\": null}\n");
+    }
+    fflush(out);
+}
+
+// One JSON object per line and configuration: every dispatch rule on its own,
+// the sequential solver, and the parallel solver at each thread count.
+// Efficiency is the sequential median over (parallel median * threads).
+int run_benchmark(const char* instance, const jobshop_t* jss, const solver_config_t* config,
+    const bench_options_t* options, FILE* out) {
+    arena_t arena;
+    arena_init(&arena, 0);
+    jobshop_solution_t solution;
+    dispatch_scratch_t scratch;
+    double* samples = arena_alloc(&arena, (size_t)options->repeats * sizeof(double));
+    if (!samples || jobshop_solution_init(&solution, &arena, jss) < 0
+        || dispatch_scratch_init(&scratch, &arena, jss) < 0) {
+        arena_destroy(&arena);
+        return -1;
+    }
+
+    bench_case_t bench = {
+        .jss = jss,
+        .config = config,
+        .solution = &solution,
+        .scratch = &scratch,
+    };
+    bench_stats_t stats;
+    long rollout_ops = jss->num_operations;
+    long solver_ops = rollout_ops * (DISPATCH_RULE_COUNT + config->restarts);
+
+    for (int i = 0; i < DISPATCH_RULE_COUNT; i++) {
+        char name[32];
+        bench.kind = BENCH_RULE;
+        bench.rule = multi_pass_rules[i];
+        if (measure(&bench, options, samples, &stats) < 0) {
+            arena_destroy(&arena);
+            return -1;
+        }
+        snprintf(name, sizeof(name), "rule:%s", dispatch_rule_name(bench.rule));
+        print_record(out, instance, jss, name, 1, options, &stats, solution.makespan, rollout_ops, -1.0);
+    }
+
+    bench.kind = BENCH_SEQUENTIAL;
+    if (measure(&bench, options, samples, &stats) < 0) {
+        arena_destroy(&arena);
+        return -1;
+    }
+    double sequential_median = stats.median;
+    print_record(out, instance, jss, "sequential", 1, options, &stats, solution.makespan, solver_ops, 1.0);
+
+    for (int i = 0; i < options->num_thread_counts; i++) {
+        bench.kind = BENCH_PARALLEL;
+        bench.num_threads = options->thread_counts[i];
+        if (measure(&bench, options, samples, &stats) < 0) {
+            arena_destroy(&arena);
+            return -1;
+        }
+        double efficiency = sequential_median / (stats.median * bench.num_threads);
+        print_record(out, instance, jss, "parallel", bench.num_threads, options, &stats, solution.makespan,
+            solver_ops, efficiency);
+    }
+
+    arena_destroy(&arena);
+    return 0;
+}
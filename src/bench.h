@@ -0,0 +1,20 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "jobshop.h"
+#include <stdio.h>
+
+#define BENCH_MAX_THREAD_COUNTS 32
+
+typedef struct {
+    int warmup; // Untimed runs before measuring each configuration
+    int repeats; // Timed runs per configuration
+    int thread_counts[BENCH_MAX_THREAD_COUNTS];
+    int num_thread_counts;
+} bench_options_t;
+
+int parse_thread_list(const char* text, bench_options_t* options);
+int run_benchmark(const char* instance, const jobshop_t* jss, const solver_config_t* config,
+    const bench_options_t* options, FILE* out);
+
+#endif
@@ -0,0 +1,201 @@
+#include "bounds.h"
+#include "affinity.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <limits.h>
+#include <omp.h>
+#include <stdlib.h>
+
+// Binary heaps of indices: releases ordered by smallest head, ready operations
+// by largest tail. Ties go to the lower index so the schedule is deterministic.
+static inline int release_before(const int* heads, int a, int b) {
+    return heads[a] < heads[b] || (heads[a] == heads[b] && a < b);
+}
+
+static inline int ready_before(const int* tails, int a, int b) {
+    return tails[a] > tails[b] || (tails[a] == tails[b] && a < b);
+}
+
+#define HEAP_SIFT_DOWN(heap, count, pos, before, keys)                                  \
+    do {                                                                                \
+        int node = (pos);                                                               \
+        for (;;) {                                                                      \
+            int child = 2 * node + 1;                                                   \
+            if (child >= (count)) {                                                     \
+                break;                                                                  \
+            }                                                                           \
+            if (child + 1 < (count) && before(keys, (heap)[child + 1], (heap)[child])) { \
+                child++;                                                                \
+            }                                                                           \
+            if (!before(keys, (heap)[child], (heap)[node])) {                           \
+                break;                                                                  \
+            }                                                                           \
+            int tmp = (heap)[node];                                                     \
+            (heap)[node] = (heap)[child];                                               \
+            (heap)[child] = tmp;                                                        \
+            node = child;                                                               \
+        }                                                                               \
+    } while (0)
+
+#define HEAP_SIFT_UP(heap, pos, before, keys)                   \
+    do {                                                        \
+        int node = (pos);                                       \
+        while (node > 0) {                                      \
+            int parent = (node - 1) / 2;                        \
+            if (!before(keys, (heap)[node], (heap)[parent])) {  \
+                break;                                          \
+            }                                                   \
+            int tmp = (heap)[node];                             \
+            (heap)[node] = (heap)[parent];                      \
+            (heap)[parent] = tmp;                               \
+            node = parent;                                      \
+        }                                                       \
+    } while (0)
+
+// Jackson's preemptive schedule: always run the released operation with the
+// longest tail. Its makespan bounds the non-preemptive one-machine problem.
+// O(count log count); remaining is consumed, scratch holds 2 * count ints.
+int jackson_preemptive_bound(const int* heads, int* remaining, const int* tails, int count, int* scratch) {
+    int* releases = scratch;
+    int* ready = scratch + count;
+    int num_releases = count;
+    int num_ready = 0;
+    for (int i = 0; i < count; i++) {
+        releases[i] = i;
+    }
+    for (int i = count / 2 - 1; i >= 0; i--) {
+        HEAP_SIFT_DOWN(releases, num_releases, i, release_before, heads);
+    }
+
+    int bound = 0;
+    int time = count > 0 ? heads[releases[0]] : 0;
+    while (num_releases > 0 || num_ready > 0) {
+        while (num_releases > 0 && heads[releases[0]] <= time) {
+            ready[num_ready] = releases[0];
+            HEAP_SIFT_UP(ready, num_ready, ready_before, tails);
+            num_ready++;
+            releases[0] = releases[--num_releases];
+            HEAP_SIFT_DOWN(releases, num_releases, 0, release_before, heads);
+        }
+        if (num_ready == 0) {
+            time = heads[releases[0]];
+            continue;
+        }
+
+        // Run the top operation until it finishes or the next release may preempt it
+        int current = ready[0];
+        int run = remaining[current];
+        if (num_releases > 0 && heads[releases[0]] - time < run) {
+            run = heads[releases[0]] - time;
+        }
+        time += run;
+        remaining[current] -= run;
+        if (remaining[current] == 0) {
+            bound = max(bound, time + tails[current]);
+            ready[0] = ready[--num_ready];
+            HEAP_SIFT_DOWN(ready, num_ready, 0, ready_before, tails);
+        }
+    }
+    return bound;
+}
+
+// Static bounds of the whole instance. Heads are the work before an operation
+// in its job and tails the work after it; machines are bounded in parallel.
+int compute_lower_bound(const jobshop_t* jss, int num_threads, lower_bound_t* bound) {
+    int n = jss->num_operations;
+    int machines = jss->num_machines;
+    int* offsets = calloc((size_t)machines + 1, sizeof(int));
+    int* ops = malloc((size_t)n * sizeof(int));
+    int* job_work = malloc((size_t)n * sizeof(int)); // Total work of each operation's job
+    if (!offsets || !ops || !job_work) {
+        free(offsets);
+        free(ops);
+        free(job_work);
+        return -1;
+    }
+
+    int job_bound = 0;
+    for (int job = 0; job < jss->num_jobs; job++) {
+        int first = jss->job_offsets[job];
+        int total = first < jss->job_offsets[job + 1] ? jss->remaining_work[first] : 0;
+        for (int op = first; op < jss->job_offsets[job + 1]; op++) {
+            job_work[op] = total;
+        }
+        job_bound = max(job_bound, total);
+    }
+
+    // Operations bucketed by machine
+    for (int op = 0; op < n; op++) {
+        offsets[jss->machines[op] + 1]++;
+    }
+    for (int m = 0; m < machines; m++) {
+        offsets[m + 1] += offsets[m];
+    }
+    for (int job = 0; job < jss->num_jobs; job++) {
+        for (int op = jss->job_offsets[job]; op < jss->job_offsets[job + 1]; op++) {
+            ops[offsets[jss->machines[op]]++] = op;
+        }
+    }
+    for (int m = machines; m > 0; m--) {
+        offsets[m] = offsets[m - 1];
+    }
+    offsets[0] = 0;
+
+    int machine_bound = 0;
+    int jackson_bound = 0;
+    int failed = 0;
+    // Per machine, Jackson's bound costs about what a rollout spends on its operations
+    int threads = num_threads > 1
+        ? get_optimal_thread_count(machines, dispatch_rollout_seconds(jss) / machines, num_threads)
+        : 1;
+#pragma omp parallel num_threads(threads) \
+    reduction(max : machine_bound, jackson_bound) reduction(| : failed)
+    {
+        const jobshop_t* local = affinity_local_instance(jss);
+        int largest = 0;
+        for (int m = 0; m < machines; m++) {
+            largest = max(largest, offsets[m + 1] - offsets[m]);
+        }
+        int* scratch = malloc((size_t)(5 * largest + 1) * sizeof(int));
+        failed = !scratch;
+
+#pragma omp for schedule(dynamic)
+        for (int m = 0; m < machines; m++) {
+            int count = offsets[m + 1] - offsets[m];
+            if (failed || count == 0) {
+                continue;
+            }
+            int* heads = scratch + 2 * largest;
+            int* remaining = heads + largest;
+            int* tails = remaining + largest;
+            int min_head = INT_MAX;
+            int min_tail = INT_MAX;
+            long long load = 0;
+            for (int i = 0; i < count; i++) {
+                int op = ops[offsets[m] + i];
+                heads[i] = job_work[op] - local->remaining_work[op];
+                tails[i] = local->remaining_work[op] - local->times[op];
+                remaining[i] = local->times[op];
+                load += local->times[op];
+                min_head = heads[i] < min_head ? heads[i] : min_head;
+                min_tail = tails[i] < min_tail ? tails[i] : min_tail;
+            }
+            machine_bound = max(machine_bound, min_head + (int)load + min_tail);
+            jackson_bound = max(jackson_bound, jackson_preemptive_bound(heads, remaining, tails, count, scratch));
+        }
+        free(scratch);
+    }
+
+    free(offsets);
+    free(ops);
+    free(job_work);
+    if (failed) {
+        return -1;
+    }
+    bound->job_bound = job_bound;
+    bound->machine_bound = machine_bound;
+    bound->jackson_bound = jackson_bound;
+    bound->value = max(job_bound, max(machine_bound, jackson_bound));
+    return 0;
+}
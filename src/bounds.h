@@ -0,0 +1,21 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include "jobshop.h"
+
+typedef struct {
+    int job_bound; // Longest job
+    int machine_bound; // Per machine: earliest head + total load + shortest tail
+    int jackson_bound; // Per machine: preemptive one-machine schedule with heads and tails
+    int value; // Max of the three
+} lower_bound_t;
+
+// Relative distance of a makespan above the bound, in percent
+static inline double lower_bound_gap(int makespan, int lower_bound) {
+    return lower_bound > 0 ? 100.0 * (makespan - lower_bound) / lower_bound : 0.0;
+}
+
+int jackson_preemptive_bound(const int* heads, int* remaining, const int* tails, int count, int* scratch);
+int compute_lower_bound(const jobshop_t* jss, int num_threads, lower_bound_t* bound);
+
+#endif
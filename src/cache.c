@@ -0,0 +1,214 @@
+#define _POSIX_C_SOURCE 200809L
+#include "cache.h"
+#include "instance.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    int32_t num_jobs;
+    int32_t num_machines;
+    uint64_t instance_hash;
+    uint64_t config_hash;
+    int32_t makespan;
+    int32_t rule_used;
+} cache_header_t;
+
+static uint64_t cache_mix(uint64_t hash, uint64_t value) {
+    return (hash ^ value) * 0x100000001b3ULL;
+}
+
+// Everything that changes the schedule a run produces. Thread counts only
+// matter where results depend on them: parallel GA islands, iterated greedy
+// chains and portfolios.
+// Time limits are left out; cut-short results are never stored under a key.
+uint64_t cache_config_hash(const solver_config_t* config, execution_mode_t mode, int exact, int portfolio) {
+    int threads_matter = mode == MODE_PARALLEL
+        && (config->ga_generations > 0 || config->ig_iterations > 0 || portfolio > 0);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = cache_mix(hash, (uint64_t)mode);
+    hash = cache_mix(hash, threads_matter ? (uint64_t)config->num_threads : 0);
+    hash = cache_mix(hash, config->seed);
+    hash = cache_mix(hash, (uint64_t)config->restarts);
+    hash = cache_mix(hash, (uint64_t)config->rcl_size);
+    hash = cache_mix(hash, (uint64_t)config->tabu_iterations);
+    hash = cache_mix(hash, (uint64_t)config->ga_generations);
+    hash = cache_mix(hash, (uint64_t)config->ga_population);
+    hash = cache_mix(hash, (uint64_t)exact);
+    hash = cache_mix(hash, (uint64_t)portfolio);
+    if (config->ig_iterations > 0) {
+        hash = cache_mix(hash, (uint64_t)config->ig_iterations); // Keeps earlier keys valid
+    }
+    // Never collides with the best-known entry
+    return hash == CACHE_BEST ? 1 : hash;
+}
+
+int cache_open(solution_cache_t* cache, const char* dir, const jobshop_t* jss) {
+    if (mkdir(dir, 0777) < 0 && errno != EEXIST) {
+        fprintf(stderr, "Error: Cannot create cache directory '%s': %s\n", dir, strerror(errno));
+        return -1;
+    }
+    cache->dir = dir;
+    cache->instance_hash = cache_mix(cache_mix(jobshop_checksum(jss), (uint64_t)jss->num_jobs),
+        (uint64_t)jss->num_machines);
+    return 0;
+}
+
+static void cache_path(const solution_cache_t* cache, uint64_t config_hash, char* path, size_t size) {
+    if (config_hash == CACHE_BEST) {
+        snprintf(path, size, "%s/%016llx.jssc", cache->dir, (unsigned long long)cache->instance_hash);
+    } else {
+        snprintf(path, size, "%s/%016llx-%016llx.jssc", cache->dir, (unsigned long long)cache->instance_hash,
+            (unsigned long long)config_hash);
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Hits are reported as proven and used as warm starts, so a stored schedule
+// must still respect job order and never run two operations on one machine
+// at once. Returns 1 if it does, 0 if not, -1 when out of memory.
+static int cache_feasible(const jobshop_t* jss, const jobshop_solution_t* solution) {
+    for (int job = 0; job < jss->num_jobs; job++) {
+        for (int op = jss->job_offsets[job] + 1; op < jss->job_offsets[job + 1]; op++) {
+            if (solution->schedule[op].start_time < solution->schedule[op - 1].end_time) {
+                return 0;
+            }
+        }
+    }
+
+    int n = jss->num_operations;
+    uint64_t* keys = malloc((size_t)n * sizeof(uint64_t));
+    int* counts = calloc((size_t)jss->num_machines + 1, sizeof(int));
+    if (!keys || !counts) {
+        free(keys);
+        free(counts);
+        return -1;
+    }
+
+    // Bucket by machine, then sort each bucket by (start, op)
+    for (int op = 0; op < n; op++) {
+        counts[jss->machines[op] + 1]++;
+    }
+    for (int m = 0; m < jss->num_machines; m++) {
+        counts[m + 1] += counts[m];
+    }
+    for (int op = 0; op < n; op++) {
+        int slot = counts[jss->machines[op]]++;
+        keys[slot] = ((uint64_t)(uint32_t)solution->schedule[op].start_time << 32) | (uint32_t)op;
+    }
+
+    int feasible = 1;
+    int begin = 0;
+    for (int m = 0; m < jss->num_machines && feasible; m++) {
+        int end = counts[m];
+        qsort(keys + begin, end - begin, sizeof(uint64_t), compare_u64);
+        for (int i = begin + 1; i < end && feasible; i++) {
+            int prev = (int)(keys[i - 1] & 0xffffffffu);
+            int op = (int)(keys[i] & 0xffffffffu);
+            feasible = solution->schedule[op].start_time >= solution->schedule[prev].end_time;
+        }
+        begin = end;
+    }
+
+    free(keys);
+    free(counts);
+    return feasible;
+}
+
+// Returns 1 on a hit, 0 on a miss; unreadable, mismatched or infeasible
+// entries are misses
+int cache_load(const solution_cache_t* cache, const jobshop_t* jss, uint64_t config_hash, jobshop_solution_t* solution) {
+    char path[PATH_MAX];
+    cache_path(cache, config_hash, path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    cache_header_t header;
+    int valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, CACHE_MAGIC, 4) == 0
+        && header.version == CACHE_VERSION && header.num_jobs == jss->num_jobs
+        && header.num_machines == jss->num_machines && header.instance_hash == cache->instance_hash
+        && header.config_hash == config_hash && header.rule_used >= 0 && header.rule_used <= (int32_t)NEH_CONSTRUCTION;
+
+    // Start times are read straight into the schedule buffer and expanded in place
+    compact_solution_t compact = {
+        .makespan = header.makespan,
+        .rule_used = (dispatch_rule_t)header.rule_used,
+        .start = (int*)solution->schedule,
+    };
+    int n = jss->num_operations;
+    if (valid) {
+        valid = fread(compact.start, sizeof(int), (size_t)n, file) == (size_t)n;
+    }
+    fclose(file);
+    for (int op = 0; op < n && valid; op++) {
+        valid = compact.start[op] >= 0 && compact.start[op] <= INT_MAX - jss->times[op];
+    }
+    if (!valid) {
+        fprintf(stderr, "Warning: Ignoring invalid cache entry '%s'\n", path);
+        return 0;
+    }
+
+    jobshop_solution_decode(solution, jss, &compact);
+    int makespan = 0;
+    for (int op = 0; op < n; op++) {
+        makespan = max(makespan, solution->schedule[op].end_time);
+    }
+    int feasible = cache_feasible(jss, solution);
+    if (feasible == 0 || makespan != header.makespan) {
+        fprintf(stderr, "Warning: Ignoring invalid cache entry '%s'\n", path);
+        return 0;
+    }
+    return feasible > 0;
+}
+
+// Written to a temporary name and renamed, so concurrent runs never read a partial entry
+int cache_store(const solution_cache_t* cache, const jobshop_t* jss, uint64_t config_hash,
+    const jobshop_solution_t* solution) {
+    char path[PATH_MAX];
+    char temp[PATH_MAX + 32];
+    cache_path(cache, config_hash, path, sizeof(path));
+    snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE* file = fopen(temp, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", temp);
+        return -1;
+    }
+    cache_header_t header = {
+        .version = CACHE_VERSION,
+        .num_jobs = jss->num_jobs,
+        .num_machines = jss->num_machines,
+        .instance_hash = cache->instance_hash,
+        .config_hash = config_hash,
+        .makespan = solution->makespan,
+        .rule_used = solution->rule_used,
+    };
+    memcpy(header.magic, CACHE_MAGIC, 4);
+    int failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    for (int op = 0; op < jss->num_operations && !failed; op++) {
+        int32_t start = solution->schedule[op].start_time;
+        failed = fwrite(&start, sizeof(start), 1, file) != 1;
+    }
+    if (fclose(file) != 0 || failed || rename(temp, path) < 0) {
+        fprintf(stderr, "Error: Failed to write cache entry '%s'\n", path);
+        remove(temp);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "jobshop.h"
+#include <stdint.h>
+
+// On-disk solution cache, one file per entry in a directory:
+//   <instance>-<config>.jssc  result of one configuration, returned on a hit
+//   <instance>.jssc           best schedule of any configuration, the warm start
+// Files hold a header and the start time of every operation in host byte order.
+#define CACHE_MAGIC "JSSC"
+#define CACHE_VERSION 2
+#define CACHE_BEST 0 // Config hash of the best-known entry
+
+typedef struct {
+    const char* dir;
+    uint64_t instance_hash; // Instance checksum mixed with its dimensions
+} solution_cache_t;
+
+uint64_t cache_config_hash(const solver_config_t* config, execution_mode_t mode, int exact, int portfolio);
+int cache_open(solution_cache_t* cache, const char* dir, const jobshop_t* jss);
+int cache_load(const solution_cache_t* cache, const jobshop_t* jss, uint64_t config_hash, jobshop_solution_t* solution);
+int cache_store(const solution_cache_t* cache, const jobshop_t* jss, uint64_t config_hash,
+    const jobshop_solution_t* solution);
+
+#endif
@@ -0,0 +1,475 @@
+#define _POSIX_C_SOURCE 200809L
+#include "dispatch.h"
+#include "argmin.h"
+#include "instrument.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <math.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+const dispatch_rule_t multi_pass_rules[DISPATCH_RULE_COUNT] = {
+    SHORTEST_PROCESSING_TIME,
+    LONGEST_PROCESSING_TIME,
+    SHORTEST_REMAINING_TIME,
+    MOST_WORK_REMAINING,
+    FIRST_IN_FIRST_OUT,
+    MOST_OPERATIONS_REMAINING,
+    RANDOM
+};
+
+// Lexicographic (priority, job_id) order, matching a first-minimum scan over jobs
+static inline int ready_queue_less(const ready_queue_t* queue, int a, int b) {
+    if (queue->priorities[a] != queue->priorities[b]) {
+        return queue->priorities[a] < queue->priorities[b];
+    }
+    return queue->job_ids[a] < queue->job_ids[b];
+}
+
+static inline void ready_queue_swap(ready_queue_t* queue, int a, int b) {
+    int priority = queue->priorities[a];
+    int job_id = queue->job_ids[a];
+    queue->priorities[a] = queue->priorities[b];
+    queue->job_ids[a] = queue->job_ids[b];
+    queue->priorities[b] = priority;
+    queue->job_ids[b] = job_id;
+}
+
+static void ready_queue_sift_down(ready_queue_t* queue, int idx) {
+    while (1) {
+        int smallest = idx;
+        int left = 2 * idx + 1;
+        int right = left + 1;
+        if (left < queue->count && ready_queue_less(queue, left, smallest)) {
+            smallest = left;
+        }
+        if (right < queue->count && ready_queue_less(queue, right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == idx) {
+            return;
+        }
+        ready_queue_swap(queue, idx, smallest);
+        idx = smallest;
+    }
+}
+
+static void ready_queue_push(ready_queue_t* queue, int priority, int job_id) {
+    int idx = queue->count++;
+    queue->priorities[idx] = priority;
+    queue->job_ids[idx] = job_id;
+
+    while (idx > 0) {
+        int parent = (idx - 1) / 2;
+        if (!ready_queue_less(queue, idx, parent)) {
+            break;
+        }
+        ready_queue_swap(queue, idx, parent);
+        idx = parent;
+    }
+}
+
+static int ready_queue_pop(ready_queue_t* queue) {
+    int job_id = queue->job_ids[0];
+    queue->count--;
+    queue->priorities[0] = queue->priorities[queue->count];
+    queue->job_ids[0] = queue->job_ids[queue->count];
+    ready_queue_sift_down(queue, 0);
+    return job_id;
+}
+
+// Uniform pick among the rcl_size best ready jobs, the others are re-queued
+static int ready_queue_pop_restricted(ready_queue_t* queue, int rcl_size, rng_t* rng) {
+    int priorities[MAX_RCL_SIZE];
+    int job_ids[MAX_RCL_SIZE];
+    int candidates = 0;
+    while (candidates < rcl_size && queue->count > 0) {
+        priorities[candidates] = queue->priorities[0];
+        job_ids[candidates] = ready_queue_pop(queue);
+        candidates++;
+    }
+
+    int chosen = rng_below(rng, candidates);
+    for (int i = 0; i < candidates; i++) {
+        if (i != chosen) {
+            ready_queue_push(queue, priorities[i], job_ids[i]);
+        }
+    }
+    return job_ids[chosen];
+}
+
+// RANDOM draws a fresh choice every step, so its queue is an unordered bag
+static int ready_queue_pop_random(ready_queue_t* queue, rng_t* rng) {
+    int idx = rng_below(rng, queue->count);
+    int job_id = queue->job_ids[idx];
+    queue->count--;
+    queue->job_ids[idx] = queue->job_ids[queue->count];
+    return job_id;
+}
+
+const char* dispatch_rule_name(dispatch_rule_t rule) {
+#define DISPATCH_RULE_NAME(rule, name, priority) \
+    case rule:                                   \
+        return name;
+    switch (rule) {
+        DISPATCH_RULES(DISPATCH_RULE_NAME)
+    case NEH_CONSTRUCTION:
+        return "NEH";
+    default:
+        return "UNKNOWN";
+    }
+#undef DISPATCH_RULE_NAME
+}
+
+// Inverse of dispatch_rule_name, case-sensitive; -1 for unknown names
+int dispatch_rule_from_name(const char* name, dispatch_rule_t* rule) {
+    for (int r = 0; r < DISPATCH_RULE_COUNT; r++) {
+        if (strcmp(name, dispatch_rule_name(r)) == 0) {
+            *rule = r;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Forced inline so that a constant rule folds the switch to one expression
+#define DISPATCH_INLINE static inline __attribute__((always_inline))
+
+DISPATCH_INLINE int dispatch_priority_of(const jobshop_t* jss, dispatch_rule_t rule, int job_id, int op_idx) {
+    int op = jss->job_offsets[job_id] + op_idx;
+    (void)op;
+#define DISPATCH_RULE_PRIORITY(rule, name, priority) \
+    case rule:                                       \
+        return (priority);
+    switch (rule) {
+        DISPATCH_RULES(DISPATCH_RULE_PRIORITY)
+    default:
+        return job_id; // FIFO as fallback
+    }
+#undef DISPATCH_RULE_PRIORITY
+}
+
+int dispatch_priority(const jobshop_t* jss, dispatch_rule_t rule, int job_id, int op_idx) {
+    return dispatch_priority_of(jss, rule, job_id, op_idx);
+}
+
+int dispatch_scratch_init(dispatch_scratch_t* scratch, arena_t* arena, const jobshop_t* jss) {
+    scratch->job_next_operation = arena_alloc(arena, (size_t)jss->num_jobs * sizeof(int));
+    scratch->ready_ops.priorities = arena_alloc(arena, (size_t)jss->num_jobs * sizeof(int));
+    scratch->ready_ops.job_ids = arena_alloc(arena, (size_t)jss->num_jobs * sizeof(int));
+    scratch->ready_ops.count = 0;
+    scratch->lanes = arena_alloc(arena, (size_t)argmin_padded_length(jss->num_jobs) * sizeof(int));
+    rng_seed(&scratch->rng, 0, 0);
+    if (gap_index_init(&scratch->gaps, arena, jss->num_machines, jss->num_operations) < 0
+        || !scratch->job_next_operation || !scratch->ready_ops.priorities || !scratch->ready_ops.job_ids
+        || !scratch->lanes) {
+        return -1;
+    }
+    return 0;
+}
+
+// Schedule the next operation of job_id as early as its job and machine allow,
+// in an idle gap of the machine if one is long enough
+static inline int dispatch_schedule_next(const jobshop_t* jss, int* start, gap_index_t* gaps,
+    int* job_next_operation, int job_id) {
+    int op_idx = job_next_operation[job_id]++;
+    int op = jobshop_op_index(jss, job_id, op_idx);
+
+    int job_completion_time = op_idx > 0 ? start[op - 1] + jss->times[op - 1] : 0;
+    int start_time = gap_index_place(gaps, jss->machines[op], job_completion_time, jss->times[op]);
+
+    start[op] = start_time;
+    return start_time + jss->times[op];
+}
+
+// Spins on a counter of the other pipeline side, yielding once the wait is
+// long enough that the other side may be sharing the core
+#define DISPATCH_PIPELINE_SPINS 256
+
+static int64_t dispatch_pipeline_wait(int64_t* counter, int64_t target) {
+    int64_t value;
+    for (int spins = 0; (value = __atomic_load_n(counter, __ATOMIC_ACQUIRE)) < target; spins++) {
+        if (spins >= DISPATCH_PIPELINE_SPINS) {
+            sched_yield();
+        }
+    }
+    return value;
+}
+
+// Selection side of a pipelined rollout: the job is handed to the decoder
+// instead of scheduled, only its operation counter advances here
+DISPATCH_INLINE void dispatch_emit(dispatch_pipeline_t* pipeline, int* job_next_operation, int64_t base,
+    int step, int job_id) {
+    job_next_operation[job_id]++;
+    pipeline->sequence[step] = job_id;
+    if ((step + 1) % DISPATCH_PIPELINE_BLOCK == 0) {
+        __atomic_store_n(&pipeline->produced, base + step + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Greedy rollout over dense per-job priority lanes: each step is a vector
+// argmin instead of a heap pop. Finished jobs hold ARGMIN_EMPTY, and ties go to
+// the lowest job id, so schedules match the heap exactly.
+// With a pipeline the rollout only selects and solution is unused.
+DISPATCH_INLINE int dispatch_rollout_lanes(const jobshop_t* jss, compact_solution_t* solution, dispatch_rule_t rule,
+    dispatch_scratch_t* scratch, dispatch_pipeline_t* pipeline) {
+    int* job_next_operation = scratch->job_next_operation;
+    int* lanes = scratch->lanes;
+    int num_lanes = argmin_padded_length(jss->num_jobs);
+
+    memset(job_next_operation, 0, (size_t)jss->num_jobs * sizeof(int));
+    int64_t base = 0;
+    if (pipeline) {
+        // The previous round must be decoded before its sequence is reused
+        base = pipeline->produced;
+        dispatch_pipeline_wait(&pipeline->decoded, base / jss->num_operations);
+    } else {
+        gap_index_reset(&scratch->gaps);
+        solution->rule_used = rule;
+    }
+    INSTR_ROLLOUT_BEGIN(trace);
+
+    for (int job_id = 0; job_id < jss->num_jobs; job_id++) {
+        lanes[job_id] = dispatch_priority_of(jss, rule, job_id, 0);
+    }
+    for (int lane = jss->num_jobs; lane < num_lanes; lane++) {
+        lanes[lane] = ARGMIN_EMPTY;
+    }
+    INSTR_PRIORITY_EVALS(trace, jss->num_jobs);
+
+    int makespan = 0;
+    int step = 0;
+    int ready = jss->num_jobs;
+    while (ready > 0) {
+        INSTR_READY_SET(trace, ready);
+        int job_id = argmin_i32(lanes, num_lanes);
+        if (pipeline) {
+            dispatch_emit(pipeline, job_next_operation, base, step++, job_id);
+        } else {
+            int end_time = dispatch_schedule_next(jss, solution->start, &scratch->gaps, job_next_operation,
+                job_id);
+            makespan = max(makespan, end_time);
+        }
+
+        int op_idx = job_next_operation[job_id];
+        if (op_idx < jss->job_offsets[job_id + 1] - jss->job_offsets[job_id]) {
+            lanes[job_id] = dispatch_priority_of(jss, rule, job_id, op_idx);
+            INSTR_PRIORITY_EVALS(trace, 1);
+        } else {
+            lanes[job_id] = ARGMIN_EMPTY;
+            ready--;
+        }
+    }
+
+    INSTR_ROLLOUT_END(trace, rule);
+    if (pipeline) {
+        __atomic_store_n(&pipeline->produced, base + step, __ATOMIC_RELEASE);
+    } else {
+        solution->makespan = makespan;
+    }
+    return makespan;
+}
+
+// rcl_size <= 1 is the plain greedy rule; with a pipeline it only selects
+DISPATCH_INLINE int dispatch_rollout_heap(const jobshop_t* jss, compact_solution_t* solution, dispatch_rule_t rule,
+    int rcl_size, dispatch_scratch_t* scratch, dispatch_pipeline_t* pipeline) {
+    int* job_next_operation = scratch->job_next_operation;
+    ready_queue_t ready_ops = scratch->ready_ops;
+
+    memset(job_next_operation, 0, (size_t)jss->num_jobs * sizeof(int));
+    int64_t base = 0;
+    if (pipeline) {
+        // The previous round must be decoded before its sequence is reused
+        base = pipeline->produced;
+        dispatch_pipeline_wait(&pipeline->decoded, base / jss->num_operations);
+    } else {
+        gap_index_reset(&scratch->gaps);
+        solution->rule_used = rule;
+    }
+    INSTR_ROLLOUT_BEGIN(trace);
+
+    // Every job starts with its first operation ready; all priorities are
+    // static per (job, operation) so the queue only changes when a job advances
+    for (int job_id = 0; job_id < jss->num_jobs; job_id++) {
+        ready_ops.priorities[job_id] = dispatch_priority_of(jss, rule, job_id, 0);
+        ready_ops.job_ids[job_id] = job_id;
+    }
+    ready_ops.count = jss->num_jobs;
+    INSTR_PRIORITY_EVALS(trace, jss->num_jobs);
+    if (rule != RANDOM) {
+        for (int idx = ready_ops.count / 2 - 1; idx >= 0; idx--) {
+            ready_queue_sift_down(&ready_ops, idx);
+        }
+    }
+
+    int makespan = 0;
+    int step = 0;
+    while (ready_ops.count > 0) {
+        INSTR_READY_SET(trace, ready_ops.count);
+        int job_id;
+        if (rule == RANDOM) {
+            job_id = ready_queue_pop_random(&ready_ops, &scratch->rng);
+        } else if (rcl_size > 1) {
+            job_id = ready_queue_pop_restricted(&ready_ops, rcl_size, &scratch->rng);
+        } else {
+            job_id = ready_queue_pop(&ready_ops);
+        }
+        if (pipeline) {
+            dispatch_emit(pipeline, job_next_operation, base, step++, job_id);
+        } else {
+            int end_time = dispatch_schedule_next(jss, solution->start, &scratch->gaps, job_next_operation,
+                job_id);
+            makespan = max(makespan, end_time);
+        }
+
+        // Re-queue the job's next operation
+        int op_idx = job_next_operation[job_id];
+        if (op_idx < jss->job_offsets[job_id + 1] - jss->job_offsets[job_id]) {
+            ready_queue_push(&ready_ops, dispatch_priority_of(jss, rule, job_id, op_idx), job_id);
+            INSTR_PRIORITY_EVALS(trace, 1);
+        }
+    }
+
+    INSTR_ROLLOUT_END(trace, rule);
+    if (pipeline) {
+        __atomic_store_n(&pipeline->produced, base + step, __ATOMIC_RELEASE);
+    } else {
+        solution->makespan = makespan;
+    }
+    return makespan;
+}
+
+// One copy of each rollout per rule, with the rule a compile-time constant:
+// the priority is a single inlined expression and the RANDOM checks vanish
+typedef int (*dispatch_lanes_kernel_t)(const jobshop_t* jss, compact_solution_t* solution,
+    dispatch_scratch_t* scratch);
+typedef int (*dispatch_heap_kernel_t)(const jobshop_t* jss, compact_solution_t* solution, int rcl_size,
+    dispatch_scratch_t* scratch);
+typedef void (*dispatch_select_kernel_t)(const jobshop_t* jss, dispatch_pipeline_t* pipeline,
+    dispatch_scratch_t* scratch);
+
+#define DISPATCH_RULE_KERNELS(rule, name, priority)                                                             \
+    static int dispatch_lanes_##rule(const jobshop_t* jss, compact_solution_t* solution,                        \
+        dispatch_scratch_t* scratch) {                                                                          \
+        return dispatch_rollout_lanes(jss, solution, rule, scratch, NULL);                                      \
+    }                                                                                                           \
+    static int dispatch_heap_##rule(const jobshop_t* jss, compact_solution_t* solution, int rcl_size,           \
+        dispatch_scratch_t* scratch) {                                                                          \
+        return dispatch_rollout_heap(jss, solution, rule, rcl_size, scratch, NULL);                             \
+    }                                                                                                           \
+    static void dispatch_select_##rule(const jobshop_t* jss, dispatch_pipeline_t* pipeline,                     \
+        dispatch_scratch_t* scratch) {                                                                          \
+        if (rule != RANDOM && jss->num_jobs >= DISPATCH_LANE_MIN_JOBS                                           \
+            && jss->num_jobs <= DISPATCH_LANE_MAX_JOBS) {                                                       \
+            dispatch_rollout_lanes(jss, NULL, rule, scratch, pipeline);                                         \
+        } else {                                                                                                \
+            dispatch_rollout_heap(jss, NULL, rule, 1, scratch, pipeline);                                       \
+        }                                                                                                       \
+    }
+DISPATCH_RULES(DISPATCH_RULE_KERNELS)
+#undef DISPATCH_RULE_KERNELS
+
+#define DISPATCH_LANES_ENTRY(rule, name, priority) [rule] = dispatch_lanes_##rule,
+#define DISPATCH_HEAP_ENTRY(rule, name, priority) [rule] = dispatch_heap_##rule,
+#define DISPATCH_SELECT_ENTRY(rule, name, priority) [rule] = dispatch_select_##rule,
+static const dispatch_lanes_kernel_t dispatch_lanes_kernels[DISPATCH_RULE_COUNT] = {
+    DISPATCH_RULES(DISPATCH_LANES_ENTRY)
+};
+static const dispatch_heap_kernel_t dispatch_heap_kernels[DISPATCH_RULE_COUNT] = {
+    DISPATCH_RULES(DISPATCH_HEAP_ENTRY)
+};
+static const dispatch_select_kernel_t dispatch_select_kernels[DISPATCH_RULE_COUNT] = {
+    DISPATCH_RULES(DISPATCH_SELECT_ENTRY)
+};
+#undef DISPATCH_LANES_ENTRY
+#undef DISPATCH_HEAP_ENTRY
+#undef DISPATCH_SELECT_ENTRY
+
+// Greedy for rcl_size <= 1, otherwise a random pick among the rcl_size best
+int dispatch_rollout(const jobshop_t* jss, compact_solution_t* solution, dispatch_rule_t rule, int rcl_size,
+    dispatch_scratch_t* scratch) {
+    if (rcl_size <= 1 && rule != RANDOM && jss->num_jobs >= DISPATCH_LANE_MIN_JOBS
+        && jss->num_jobs <= DISPATCH_LANE_MAX_JOBS) {
+        return dispatch_lanes_kernels[rule](jss, solution, scratch);
+    }
+    if (rcl_size > MAX_RCL_SIZE) {
+        rcl_size = MAX_RCL_SIZE;
+    }
+    return dispatch_heap_kernels[rule](jss, solution, rcl_size, scratch);
+}
+
+// Active decoding of an operation-based sequence: each occurrence of a job
+// id schedules that job's next operation. The sequence must hold every job id
+// exactly as many times as the job has operations.
+int dispatch_sequence(const jobshop_t* jss, compact_solution_t* solution, const int* sequence,
+    dispatch_scratch_t* scratch) {
+    int* job_next_operation = scratch->job_next_operation;
+    gap_index_reset(&scratch->gaps);
+    memset(job_next_operation, 0, (size_t)jss->num_jobs * sizeof(int));
+
+    int makespan = 0;
+    for (int i = 0; i < jss->num_operations; i++) {
+        int end_time = dispatch_schedule_next(jss, solution->start, &scratch->gaps, job_next_operation,
+            sequence[i]);
+        makespan = max(makespan, end_time);
+    }
+
+    solution->makespan = makespan;
+    return makespan;
+}
+
+int dispatch_pipeline_init(dispatch_pipeline_t* pipeline, arena_t* arena, const jobshop_t* jss) {
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->sequence = arena_alloc(arena, (size_t)jss->num_operations * sizeof(int));
+    return pipeline->sequence ? 0 : -1;
+}
+
+// Same order as the greedy dispatch_rollout, the RANDOM stream included
+void dispatch_pipeline_select(const jobshop_t* jss, dispatch_pipeline_t* pipeline, dispatch_rule_t rule,
+    dispatch_scratch_t* scratch) {
+    dispatch_select_kernels[rule](jss, pipeline, scratch);
+}
+
+// Decodes the next round's sequence as it arrives; the result equals
+// dispatch_rollout with the same rule and random stream
+int dispatch_pipeline_decode(const jobshop_t* jss, dispatch_pipeline_t* pipeline, compact_solution_t* solution,
+    dispatch_rule_t rule, dispatch_scratch_t* scratch) {
+    int* job_next_operation = scratch->job_next_operation;
+    gap_index_reset(&scratch->gaps);
+    memset(job_next_operation, 0, (size_t)jss->num_jobs * sizeof(int));
+
+    int64_t round = pipeline->decoded;
+    int64_t base = round * jss->num_operations;
+    int64_t available = base;
+    int makespan = 0;
+    for (int i = 0; i < jss->num_operations; i++) {
+        if (base + i >= available) {
+            available = dispatch_pipeline_wait(&pipeline->produced, base + i + 1);
+        }
+        int end_time = dispatch_schedule_next(jss, solution->start, &scratch->gaps, job_next_operation,
+            pipeline->sequence[i]);
+        makespan = max(makespan, end_time);
+    }
+
+    __atomic_store_n(&pipeline->decoded, round + 1, __ATOMIC_RELEASE);
+    solution->rule_used = rule;
+    solution->makespan = makespan;
+    return makespan;
+}
+
+// Expected wall time of one greedy rollout, for sizing parallel regions:
+// steps cost about the heap depth each, DISPATCH_SECONDS_PER_LEVEL apiece
+double dispatch_rollout_seconds(const jobshop_t* jss) {
+    return DISPATCH_SECONDS_PER_LEVEL * jss->num_operations * log2(jss->num_jobs > 4 ? jss->num_jobs : 4);
+}
+
+// Full schedule for callers outside the search loops: the start times are
+// produced inside the schedule buffer and expanded in place
+int solve_with_dispatch_rule(const jobshop_t* jss, jobshop_solution_t* solution, dispatch_rule_t rule,
+    dispatch_scratch_t* scratch) {
+    compact_solution_t compact = { .start = (int*)solution->schedule };
+    int makespan = dispatch_rollout(jss, &compact, rule, 1, scratch);
+    jobshop_solution_decode(solution, jss, &compact);
+    return makespan;
+}
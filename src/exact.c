@@ -0,0 +1,329 @@
+#include "exact.h"
+#include "anytime.h"
+#include "bounds.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <limits.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BNB_TASK_DEPTH 3 // Subtrees above this depth become OpenMP tasks
+#define BNB_MAX_THREADS 256
+// Work between deadline checks, in units of job x operation: a node bounds up
+// to num_jobs children at O(operations) each, so large instances check every
+// few nodes and small ones every few thousand
+#define BNB_CLOCK_WORK (1L << 20)
+
+// Partial active schedule; all arrays live in one allocation owned by the state
+typedef struct {
+    int* job_next; // Next unscheduled operation index within each job
+    int* job_ready; // Completion time of each job's last scheduled operation
+    int* machine_ready;
+    int* start; // Start time per flat operation
+    int* candidates; // Conflict set (job, bound) pairs, num_jobs pairs per depth
+    int* heads; // Lower bound scratch, num_jobs entries per machine
+    int* remaining;
+    int* tails;
+    int* counts; // Unscheduled operations per machine
+    int* jackson; // Heap scratch for the one-machine bound, 2 * num_jobs entries
+    int scheduled;
+} bnb_state_t;
+
+typedef struct {
+    long nodes;
+    char padding[64 - sizeof(long)];
+} bnb_counter_t;
+
+typedef struct {
+    const jobshop_t* jss;
+    int upper_bound;
+    int* best_start;
+    int parallel;
+    long clock_interval; // Nodes per thread between deadline checks
+    anytime_t* anytime;
+    bnb_counter_t counters[BNB_MAX_THREADS];
+} bnb_shared_t;
+
+static bnb_state_t* state_create(const jobshop_t* jss) {
+    int jobs = jss->num_jobs;
+    int machines = jss->num_machines;
+    size_t ints = 2 * (size_t)jobs + (size_t)machines + (size_t)jss->num_operations
+        + 2 * (size_t)(jss->num_operations + 1) * jobs + 3 * (size_t)machines * jobs + (size_t)machines + 2 * (size_t)jobs;
+    bnb_state_t* state = malloc(sizeof(bnb_state_t) + ints * sizeof(int));
+    if (!state) {
+        return NULL;
+    }
+    int* data = (int*)(state + 1);
+    state->job_next = data;
+    state->job_ready = state->job_next + jobs;
+    state->machine_ready = state->job_ready + jobs;
+    state->start = state->machine_ready + machines;
+    state->candidates = state->start + jss->num_operations;
+    state->heads = state->candidates + 2 * (size_t)(jss->num_operations + 1) * jobs;
+    state->remaining = state->heads + (size_t)machines * jobs;
+    state->tails = state->remaining + (size_t)machines * jobs;
+    state->counts = state->tails + (size_t)machines * jobs;
+    state->jackson = state->counts + machines;
+    state->scheduled = 0;
+    return state;
+}
+
+static bnb_state_t* state_clone(const bnb_state_t* src, const jobshop_t* jss) {
+    bnb_state_t* state = state_create(jss);
+    if (!state) {
+        return NULL;
+    }
+    memcpy(state->job_next, src->job_next, (size_t)jss->num_jobs * sizeof(int));
+    memcpy(state->job_ready, src->job_ready, (size_t)jss->num_jobs * sizeof(int));
+    memcpy(state->machine_ready, src->machine_ready, (size_t)jss->num_machines * sizeof(int));
+    memcpy(state->start, src->start, (size_t)jss->num_operations * sizeof(int));
+    state->scheduled = src->scheduled;
+    return state;
+}
+
+// Max of the job bounds and of a preemptive one-machine bound per machine
+static int lower_bound(const bnb_state_t* state, const jobshop_t* jss) {
+    int jobs = jss->num_jobs;
+    int bound = 0;
+    for (int m = 0; m < jss->num_machines; m++) {
+        state->counts[m] = 0;
+        bound = max(bound, state->machine_ready[m]);
+    }
+
+    for (int job = 0; job < jobs; job++) {
+        int first = jss->job_offsets[job] + state->job_next[job];
+        int end = jss->job_offsets[job + 1];
+        if (first >= end) {
+            continue;
+        }
+        // Heads propagate along the job chain, none can start before its machine is free
+        int head = state->job_ready[job];
+        for (int op = first; op < end; op++) {
+            int m = jss->machines[op];
+            int slot = m * jobs + state->counts[m]++;
+            head = max(head, state->machine_ready[m]);
+            state->heads[slot] = head;
+            state->remaining[slot] = jss->times[op];
+            state->tails[slot] = jss->remaining_work[op] - jss->times[op];
+            head += jss->times[op];
+        }
+        bound = max(bound, head);
+    }
+
+    for (int m = 0; m < jss->num_machines; m++) {
+        if (state->counts[m] > 0) {
+            int base = m * jobs;
+            bound = max(bound, jackson_preemptive_bound(state->heads + base, state->remaining + base,
+                                   state->tails + base, state->counts[m], state->jackson));
+        }
+    }
+    return bound;
+}
+
+static int read_upper_bound(bnb_shared_t* shared) {
+    int upper_bound;
+#pragma omp atomic read
+    upper_bound = shared->upper_bound;
+    return upper_bound;
+}
+
+static void record_incumbent(bnb_shared_t* shared, const bnb_state_t* state, int makespan) {
+#pragma omp critical(bnb_incumbent)
+    {
+        if (makespan < shared->upper_bound) {
+            memcpy(shared->best_start, state->start, (size_t)shared->jss->num_operations * sizeof(int));
+#pragma omp atomic write
+            shared->upper_bound = makespan;
+            anytime_publish(shared->anytime, makespan, "exact");
+        }
+    }
+}
+
+static void branch(bnb_shared_t* shared, bnb_state_t* state, int depth);
+
+static void branch_task(bnb_shared_t* shared, bnb_state_t* state, int depth) {
+    branch(shared, state, depth);
+    free(state);
+}
+
+static inline void schedule_op(bnb_state_t* state, int job, int op, int machine, int start, int end) {
+    state->job_next[job]++;
+    state->job_ready[job] = end;
+    state->machine_ready[machine] = end;
+    state->start[op] = start;
+    state->scheduled++;
+}
+
+// Giffler-Thompson branching: the operation with the earliest completion fixes
+// a machine, and every operation on it that could start before that
+// completion is tried first in turn. Only active schedules are enumerated.
+// Children are bounded before descending and visited best bound first.
+static void branch(bnb_shared_t* shared, bnb_state_t* state, int depth) {
+    const jobshop_t* jss = shared->jss;
+    long nodes = ++shared->counters[omp_get_thread_num() % BNB_MAX_THREADS].nodes;
+    if (anytime_cancelled(shared->anytime)
+        || (nodes % shared->clock_interval == 0 && anytime_expired(shared->anytime))) {
+        return; // Unwinds the whole tree within a few microseconds
+    }
+
+    if (state->scheduled == jss->num_operations) {
+        int makespan = 0;
+        for (int m = 0; m < jss->num_machines; m++) {
+            makespan = max(makespan, state->machine_ready[m]);
+        }
+        if (makespan < read_upper_bound(shared)) {
+            record_incumbent(shared, state, makespan);
+        }
+        return;
+    }
+
+    int best_completion = INT_MAX;
+    int best_machine = -1;
+    int best_job = -1;
+    for (int job = 0; job < jss->num_jobs; job++) {
+        int op = jss->job_offsets[job] + state->job_next[job];
+        if (op >= jss->job_offsets[job + 1]) {
+            continue;
+        }
+        int est = max(state->job_ready[job], state->machine_ready[jss->machines[op]]);
+        if (est + jss->times[op] < best_completion) {
+            best_completion = est + jss->times[op];
+            best_machine = jss->machines[op];
+            best_job = job;
+        }
+    }
+
+    int* candidates = state->candidates + 2 * (size_t)depth * jss->num_jobs;
+    int count = 0;
+    int upper_bound = read_upper_bound(shared);
+    for (int job = 0; job < jss->num_jobs; job++) {
+        int op = jss->job_offsets[job] + state->job_next[job];
+        if (op >= jss->job_offsets[job + 1] || jss->machines[op] != best_machine) {
+            continue;
+        }
+        int start = max(state->job_ready[job], state->machine_ready[best_machine]);
+        // A zero-length operation completes where it starts, so the one that
+        // fixed best_completion is always in its own conflict set
+        if (job != best_job && start >= best_completion) {
+            continue;
+        }
+
+        int saved_job_ready = state->job_ready[job];
+        int saved_machine_ready = state->machine_ready[best_machine];
+        schedule_op(state, job, op, best_machine, start, start + jss->times[op]);
+        int bound = lower_bound(state, jss);
+        state->scheduled--;
+        state->machine_ready[best_machine] = saved_machine_ready;
+        state->job_ready[job] = saved_job_ready;
+        state->job_next[job]--;
+        if (bound >= upper_bound) {
+            continue;
+        }
+
+        // Insertion sort by bound, ties by job id
+        int pos = count++;
+        while (pos > 0 && candidates[2 * (pos - 1) + 1] > bound) {
+            candidates[2 * pos] = candidates[2 * (pos - 1)];
+            candidates[2 * pos + 1] = candidates[2 * (pos - 1) + 1];
+            pos--;
+        }
+        candidates[2 * pos] = job;
+        candidates[2 * pos + 1] = bound;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (candidates[2 * i + 1] >= read_upper_bound(shared)) {
+            break; // Sorted, so every remaining child is pruned too
+        }
+
+        int job = candidates[2 * i];
+        int op = jss->job_offsets[job] + state->job_next[job];
+        int start = max(state->job_ready[job], state->machine_ready[best_machine]);
+        int end = start + jss->times[op];
+
+        if (shared->parallel && depth < BNB_TASK_DEPTH && count > 1) {
+            bnb_state_t* child = state_clone(state, jss);
+            if (child) {
+                schedule_op(child, job, op, best_machine, start, end);
+#pragma omp task firstprivate(child, depth) shared(shared)
+                branch_task(shared, child, depth + 1);
+                continue;
+            }
+        }
+
+        int saved_job_ready = state->job_ready[job];
+        int saved_machine_ready = state->machine_ready[best_machine];
+        schedule_op(state, job, op, best_machine, start, end);
+
+        branch(shared, state, depth + 1);
+
+        state->scheduled--;
+        state->start[op] = 0;
+        state->machine_ready[best_machine] = saved_machine_ready;
+        state->job_ready[job] = saved_job_ready;
+        state->job_next[job]--;
+    }
+}
+
+// Proves optimality of solution (used as the initial upper bound) or replaces
+// it by a better schedule. Subtrees near the root run as OpenMP tasks that
+// share the upper bound, so an improvement found by one thread immediately
+// prunes the others.
+int solve_exact(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config,
+    exact_stats_t* stats) {
+    bnb_shared_t* shared = calloc(1, sizeof(bnb_shared_t));
+    bnb_state_t* root = state_create(jss);
+    int* best_start = malloc((size_t)jss->num_operations * sizeof(int));
+    if (!shared || !root || !best_start) {
+        free(shared);
+        free(root);
+        free(best_start);
+        return -1;
+    }
+
+    memset(root->job_next, 0, (size_t)jss->num_jobs * sizeof(int));
+    memset(root->job_ready, 0, (size_t)jss->num_jobs * sizeof(int));
+    memset(root->machine_ready, 0, (size_t)jss->num_machines * sizeof(int));
+    memset(root->start, 0, (size_t)jss->num_operations * sizeof(int));
+
+    int initial = solution->makespan > 0 ? solution->makespan : INT_MAX;
+    shared->jss = jss;
+    shared->upper_bound = initial;
+    shared->best_start = best_start;
+    shared->parallel = config->num_threads > 1;
+    long work = (long)jss->num_jobs * jss->num_operations;
+    shared->clock_interval = work < BNB_CLOCK_WORK ? BNB_CLOCK_WORK / work : 1;
+    shared->anytime = config->anytime;
+
+#pragma omp parallel num_threads(config->num_threads)
+    {
+#pragma omp single
+        branch(shared, root, 0);
+    }
+
+    stats->nodes = 0;
+    for (int t = 0; t < BNB_MAX_THREADS; t++) {
+        stats->nodes += shared->counters[t].nodes;
+    }
+    stats->proven_optimal = !anytime_cancelled(config->anytime) || anytime_optimal(config->anytime);
+
+    if (shared->upper_bound < initial) {
+        solution->num_jobs = jss->num_jobs;
+        solution->num_machines = jss->num_machines;
+        solution->num_operations = jss->num_operations;
+        solution->job_offsets = jss->job_offsets;
+        for (int op = 0; op < jss->num_operations; op++) {
+            solution->schedule[op].machine_id = jss->machines[op];
+            solution->schedule[op].start_time = best_start[op];
+            solution->schedule[op].end_time = best_start[op] + jss->times[op];
+        }
+        solution->makespan = shared->upper_bound;
+    }
+
+    int makespan = solution->makespan;
+    free(shared);
+    free(root);
+    free(best_start);
+    return makespan;
+}
@@ -0,0 +1,14 @@
+#ifndef EXACT_H
+#define EXACT_H
+
+#include "jobshop.h"
+
+typedef struct {
+    long nodes;
+    int proven_optimal;
+} exact_stats_t;
+
+int solve_exact(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config,
+    exact_stats_t* stats);
+
+#endif
@@ -0,0 +1,392 @@
+#define _POSIX_C_SOURCE 200809L
+#include "flowshop.h"
+#include "affinity.h"
+#include "anytime.h"
+#include "arena.h"
+#include "jobshop.h"
+#include "rng.h"
+#include "utils.h"
+#include <limits.h>
+#include <math.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Random streams above the genetic algorithm's islands
+#define IG_STREAM_BASE 0x7f000000ULL
+
+// In a flow shop operation k of every job runs on the same machine, so a
+// schedule is a job permutation and p(job, k) = times[job * stages + k]
+int jobshop_is_flow_shop(const jobshop_t* jss) {
+    if (jss->num_jobs == 0 || jss->job_offsets[1] == 0) {
+        return 0;
+    }
+    int stages = jss->job_offsets[1];
+
+    // The permutation recurrence needs every machine at most once per route
+    unsigned char* seen = calloc((size_t)jss->num_machines, 1);
+    if (!seen) {
+        return 0;
+    }
+    int flow_shop = 1;
+    for (int k = 0; k < stages && flow_shop; k++) {
+        flow_shop = !seen[jss->machines[k]];
+        seen[jss->machines[k]] = 1;
+    }
+    free(seen);
+
+    for (int job = 1; job < jss->num_jobs && flow_shop; job++) {
+        int first = jss->job_offsets[job];
+        flow_shop = jss->job_offsets[job + 1] - first == stages
+            && memcmp(jss->machines + first, jss->machines, (size_t)stages * sizeof(int)) == 0;
+    }
+    return flow_shop;
+}
+
+// Taillard's acceleration: with heads[i][k] the completion of the first i
+// jobs on stage k and tails[i][k] the work from stage k of job i to the end,
+// inserting a job before position i costs O(stages), all positions O(n m)
+typedef struct {
+    int jobs;
+    int stages;
+    const int* times;
+    int* heads; // Rows 0..length, row i covers the first i jobs
+    int* tails; // Rows 0..length, row i covers the jobs from position i on
+} flow_workspace_t;
+
+static int flow_workspace_init(flow_workspace_t* workspace, arena_t* arena, const jobshop_t* jss) {
+    workspace->jobs = jss->num_jobs;
+    workspace->stages = jss->job_offsets[1];
+    workspace->times = jss->times;
+    size_t cells = ((size_t)jss->num_jobs + 1) * (size_t)workspace->stages;
+    workspace->heads = arena_alloc(arena, cells * sizeof(int));
+    workspace->tails = arena_alloc(arena, cells * sizeof(int));
+    return workspace->heads && workspace->tails ? 0 : -1;
+}
+
+static int flow_makespan(const flow_workspace_t* workspace, const int* sequence, int length, int* completion) {
+    int stages = workspace->stages;
+    memset(completion, 0, (size_t)stages * sizeof(int));
+    for (int i = 0; i < length; i++) {
+        const int* p = workspace->times + (size_t)sequence[i] * stages;
+        int left = 0;
+        for (int k = 0; k < stages; k++) {
+            left = max(completion[k], left) + p[k];
+            completion[k] = left;
+        }
+    }
+    return completion[stages - 1];
+}
+
+// Best position in [0, length] for job in the partial sequence, ties to the
+// earliest; the partial makespan there goes to *makespan
+static int flow_best_insertion(flow_workspace_t* workspace, const int* sequence, int length, int job, int* makespan) {
+    int stages = workspace->stages;
+    int* heads = workspace->heads;
+    int* tails = workspace->tails;
+
+    memset(heads, 0, (size_t)stages * sizeof(int));
+    for (int i = 0; i < length; i++) {
+        const int* p = workspace->times + (size_t)sequence[i] * stages;
+        const int* above = heads + (size_t)i * stages;
+        int* row = heads + (size_t)(i + 1) * stages;
+        int left = 0;
+        for (int k = 0; k < stages; k++) {
+            left = max(above[k], left) + p[k];
+            row[k] = left;
+        }
+    }
+    memset(tails + (size_t)length * stages, 0, (size_t)stages * sizeof(int));
+    for (int i = length - 1; i >= 0; i--) {
+        const int* p = workspace->times + (size_t)sequence[i] * stages;
+        const int* below = tails + (size_t)(i + 1) * stages;
+        int* row = tails + (size_t)i * stages;
+        int right = 0;
+        for (int k = stages - 1; k >= 0; k--) {
+            right = max(below[k], right) + p[k];
+            row[k] = right;
+        }
+    }
+
+    const int* p = workspace->times + (size_t)job * stages;
+    int best = INT_MAX;
+    int best_position = 0;
+    for (int i = 0; i <= length; i++) {
+        const int* above = heads + (size_t)i * stages;
+        const int* below = tails + (size_t)i * stages;
+        int left = 0;
+        int value = 0;
+        for (int k = 0; k < stages; k++) {
+            left = max(above[k], left) + p[k];
+            value = max(value, left + below[k]);
+        }
+        if (value < best) {
+            best = value;
+            best_position = i;
+        }
+    }
+    *makespan = best;
+    return best_position;
+}
+
+static void flow_insert(int* sequence, int length, int position, int job) {
+    memmove(sequence + position + 1, sequence + position, (size_t)(length - position) * sizeof(int));
+    sequence[position] = job;
+}
+
+static void flow_remove(int* sequence, int length, int position) {
+    memmove(sequence + position, sequence + position + 1, (size_t)(length - position - 1) * sizeof(int));
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// NEH: jobs by decreasing total work (ties to the lower index), each inserted
+// at its best position in the sequence built so far
+static int flow_neh(flow_workspace_t* workspace, const jobshop_t* jss, int* sequence, uint64_t* keys) {
+    int n = jss->num_jobs;
+    for (int job = 0; job < n; job++) {
+        int total = jss->remaining_work[jss->job_offsets[job]];
+        keys[job] = (uint64_t)(INT_MAX - total) << 32 | (uint32_t)job;
+    }
+    qsort(keys, (size_t)n, sizeof(uint64_t), compare_u64);
+
+    int makespan = 0;
+    for (int length = 0; length < n; length++) {
+        int job = (int)(keys[length] & 0xffffffffu);
+        int position = flow_best_insertion(workspace, sequence, length, job, &makespan);
+        flow_insert(sequence, length, position, job);
+    }
+    return makespan;
+}
+
+// Permutation schedule: every machine processes the jobs in sequence order
+static void flow_decode(const jobshop_t* jss, jobshop_solution_t* solution, const int* sequence, int* completion) {
+    int stages = jss->job_offsets[1];
+    memset(completion, 0, (size_t)stages * sizeof(int));
+    for (int i = 0; i < jss->num_jobs; i++) {
+        int left = 0;
+        for (int k = 0; k < stages; k++) {
+            int op = jss->job_offsets[sequence[i]] + k;
+            int start = max(completion[k], left);
+            left = start + jss->times[op];
+            completion[k] = left;
+            solution->schedule[op].machine_id = jss->machines[op];
+            solution->schedule[op].start_time = start;
+            solution->schedule[op].end_time = left;
+        }
+    }
+    solution->num_jobs = jss->num_jobs;
+    solution->num_machines = jss->num_machines;
+    solution->num_operations = jss->num_operations;
+    solution->job_offsets = jss->job_offsets;
+    solution->makespan = completion[stages - 1];
+}
+
+// Replaces the rule pass on flow shops: O(n^2 m) with the acceleration
+int solve_neh(const jobshop_t* jss, jobshop_solution_t* solution) {
+    int n = jss->num_jobs;
+    arena_t arena;
+    arena_init(&arena, 0);
+    flow_workspace_t workspace;
+    int* sequence = arena_alloc(&arena, (size_t)n * sizeof(int));
+    uint64_t* keys = arena_alloc(&arena, (size_t)n * sizeof(uint64_t));
+    if (!sequence || !keys || flow_workspace_init(&workspace, &arena, jss) < 0) {
+        arena_destroy(&arena);
+        return -1;
+    }
+
+    flow_neh(&workspace, jss, sequence, keys);
+    flow_decode(jss, solution, sequence, workspace.heads);
+    solution->rule_used = NEH_CONSTRUCTION;
+    arena_destroy(&arena);
+    return solution->makespan;
+}
+
+// One independent iterated greedy search per thread, on its own cache lines
+typedef struct __attribute__((aligned(CACHE_LINE_SIZE))) {
+    arena_t arena;
+    flow_workspace_t workspace;
+    rng_t rng;
+    int* current;
+    int* candidate;
+    int* best;
+    int* removed;
+    int* order; // Job order of a local search pass
+    int current_makespan;
+    int best_makespan;
+    int ready;
+} ig_chain_t;
+
+static int ig_chain_init(ig_chain_t* chain, const jobshop_t* jss) {
+    size_t n = (size_t)jss->num_jobs;
+    arena_init(&chain->arena, 0);
+    chain->current = arena_alloc(&chain->arena, n * sizeof(int));
+    chain->candidate = arena_alloc(&chain->arena, n * sizeof(int));
+    chain->best = arena_alloc(&chain->arena, n * sizeof(int));
+    chain->removed = arena_alloc(&chain->arena, IG_DESTRUCTION * sizeof(int));
+    chain->order = arena_alloc(&chain->arena, n * sizeof(int));
+    if (!chain->current || !chain->candidate || !chain->best || !chain->removed || !chain->order
+        || flow_workspace_init(&chain->workspace, &chain->arena, jss) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static double ig_uniform(rng_t* rng) {
+    return (double)(rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+// Insertion local search: every job in a random order is taken out and put
+// back at its best position, with passes repeated until none improves. A move
+// never worsens the sequence, so at the deadline the makespan so far stands.
+static int ig_local_search(ig_chain_t* chain, int* sequence, int n, int makespan, anytime_t* anytime) {
+    for (int i = 0; i < n; i++) {
+        chain->order[i] = i;
+    }
+    int improved = 1;
+    while (improved) {
+        improved = 0;
+        for (int i = n - 1; i > 0; i--) {
+            int j = rng_below(&chain->rng, i + 1);
+            int job = chain->order[i];
+            chain->order[i] = chain->order[j];
+            chain->order[j] = job;
+        }
+        for (int r = 0; r < n; r++) {
+            if (anytime_cancelled(anytime) || anytime_expired(anytime)) {
+                return makespan;
+            }
+            int job = chain->order[r];
+            int position = 0;
+            while (sequence[position] != job) {
+                position++;
+            }
+            flow_remove(sequence, n, position);
+            int value;
+            int best_position = flow_best_insertion(&chain->workspace, sequence, n - 1, job, &value);
+            flow_insert(sequence, n - 1, best_position, job);
+            if (value < makespan) {
+                makespan = value;
+                improved = 1;
+            }
+        }
+    }
+    return makespan;
+}
+
+// Ruiz and Stuetzle's iterated greedy: destruct, greedily reconstruct, local
+// search, and accept worse sequences with a constant-temperature probability
+static void ig_step(ig_chain_t* chain, int n, double temperature, anytime_t* anytime) {
+    int* candidate = chain->candidate;
+    memcpy(candidate, chain->current, (size_t)n * sizeof(int));
+
+    int destruction = n - 1 < IG_DESTRUCTION ? n - 1 : IG_DESTRUCTION;
+    int length = n;
+    for (int r = 0; r < destruction; r++) {
+        int position = rng_below(&chain->rng, length);
+        chain->removed[r] = candidate[position];
+        flow_remove(candidate, length--, position);
+    }
+    int makespan = 0;
+    for (int r = 0; r < destruction; r++) {
+        int position = flow_best_insertion(&chain->workspace, candidate, length, chain->removed[r], &makespan);
+        flow_insert(candidate, length++, position, chain->removed[r]);
+    }
+    if (destruction == 0) {
+        makespan = chain->current_makespan;
+    }
+    makespan = ig_local_search(chain, candidate, n, makespan, anytime);
+
+    if (makespan < chain->current_makespan
+        || ig_uniform(&chain->rng) < exp((chain->current_makespan - makespan) / temperature)) {
+        chain->candidate = chain->current;
+        chain->current = candidate;
+        chain->current_makespan = makespan;
+        if (makespan < chain->best_makespan) {
+            memcpy(chain->best, candidate, (size_t)n * sizeof(int));
+            chain->best_makespan = makespan;
+            anytime_publish(anytime, makespan, "ig");
+        }
+    }
+}
+
+// Parallel iterated greedy from the permutation of the current schedule, one
+// chain per thread with its own random stream. Results depend on the seed and
+// the thread count; the solution is only overwritten on improvement.
+int solve_iterated_greedy(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config) {
+    int n = jss->num_jobs;
+    int num_chains = config->num_threads > 0 ? config->num_threads : 1;
+    int* initial = malloc((size_t)n * sizeof(int));
+    uint64_t* keys = malloc((size_t)n * sizeof(uint64_t));
+    ig_chain_t* chains = cache_aligned_calloc((size_t)num_chains, sizeof(ig_chain_t));
+    if (!initial || !keys || !chains) {
+        free(initial);
+        free(keys);
+        free(chains);
+        return -1;
+    }
+
+    // Jobs by the start of their first operation: exact for permutation
+    // schedules, a starting point for any other
+    for (int job = 0; job < n; job++) {
+        uint32_t start = (uint32_t)solution->schedule[jss->job_offsets[job]].start_time;
+        keys[job] = (uint64_t)start << 32 | (uint32_t)job;
+    }
+    qsort(keys, (size_t)n, sizeof(uint64_t), compare_u64);
+    for (int i = 0; i < n; i++) {
+        initial[i] = (int)(keys[i] & 0xffffffffu);
+    }
+    free(keys);
+
+    long long total_work = 0;
+    for (int op = 0; op < jss->num_operations; op++) {
+        total_work += jss->times[op];
+    }
+    double temperature = IG_TEMPERATURE * (double)total_work / ((double)jss->num_operations * 10.0);
+    temperature = temperature > 0.0 ? temperature : 1.0;
+
+    int any_failed = 0;
+#pragma omp parallel num_threads(num_chains) reduction(| : any_failed)
+    {
+        // Allocated and first touched by the thread that runs the chain
+        ig_chain_t* chain = &chains[omp_get_thread_num()];
+        const jobshop_t* local = affinity_local_instance(jss);
+        if (ig_chain_init(chain, local) < 0) {
+            any_failed = 1;
+        } else {
+            rng_seed(&chain->rng, config->seed, IG_STREAM_BASE + (uint64_t)omp_get_thread_num());
+            memcpy(chain->current, initial, (size_t)n * sizeof(int));
+            memcpy(chain->best, initial, (size_t)n * sizeof(int));
+            chain->current_makespan = flow_makespan(&chain->workspace, initial, n, chain->workspace.heads);
+            chain->best_makespan = chain->current_makespan;
+            chain->ready = 1;
+            for (int i = 0; i < config->ig_iterations && !anytime_expired(config->anytime); i++) {
+                ig_step(chain, n, temperature, config->anytime);
+            }
+        }
+    }
+
+    // Lowest makespan wins, ties to the lowest chain
+    ig_chain_t* winner = NULL;
+    for (int c = 0; c < num_chains; c++) {
+        if (chains[c].ready && (!winner || chains[c].best_makespan < winner->best_makespan)) {
+            winner = &chains[c];
+        }
+    }
+    int makespan = solution->makespan;
+    if (!any_failed && winner && winner->best_makespan < makespan) {
+        flow_decode(jss, solution, winner->best, winner->workspace.heads);
+        makespan = solution->makespan;
+    }
+
+    for (int c = 0; c < num_chains; c++) {
+        arena_destroy(&chains[c].arena);
+    }
+    free(initial);
+    free(chains);
+    return any_failed ? -1 : makespan;
+}
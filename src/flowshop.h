@@ -0,0 +1,13 @@
+#ifndef FLOWSHOP_H
+#define FLOWSHOP_H
+
+#include "jobshop.h"
+
+#define IG_DESTRUCTION 4 // Jobs removed and reinserted per iterated greedy step
+#define IG_TEMPERATURE 0.4 // Acceptance temperature, in tenths of the mean operation time
+
+int jobshop_is_flow_shop(const jobshop_t* jss);
+int solve_neh(const jobshop_t* jss, jobshop_solution_t* solution);
+int solve_iterated_greedy(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config);
+
+#endif
@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 200809L
+#include "gaps.h"
+#include "utils.h"
+#include <string.h>
+
+int gap_index_init(gap_index_t* index, arena_t* arena, int num_machines, int num_operations) {
+    index->nodes = arena_alloc(arena, (size_t)(num_operations > 0 ? num_operations : 1) * sizeof(gap_node_t));
+    index->roots = arena_alloc(arena, (size_t)num_machines * sizeof(int));
+    index->completion = arena_alloc(arena, (size_t)num_machines * sizeof(int));
+    index->num_machines = num_machines;
+    if (!index->nodes || !index->roots || !index->completion) {
+        return -1;
+    }
+    gap_index_reset(index);
+    return 0;
+}
+
+// Empty machines: no gaps and nothing scheduled
+void gap_index_reset(gap_index_t* index) {
+    memset(index->roots, 0xff, (size_t)index->num_machines * sizeof(int));
+    memset(index->completion, 0, (size_t)index->num_machines * sizeof(int));
+    index->count = 0;
+}
+
+static inline int gap_longest(const gap_index_t* index, int node) {
+    return node < 0 ? -1 : index->nodes[node].longest;
+}
+
+static inline void gap_update(gap_index_t* index, int node) {
+    gap_node_t* n = &index->nodes[node];
+    n->longest = max(n->end - n->start, max(gap_longest(index, n->left), gap_longest(index, n->right)));
+}
+
+// Pool slots are handed out in order, so hashing the slot gives the treap
+// priorities without a random stream and keeps schedules deterministic
+static int gap_new(gap_index_t* index, int start, int end) {
+    int node = index->count++;
+    uint32_t hash = (uint32_t)node * 0x9E3779B1u;
+    hash ^= hash >> 15;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    index->nodes[node] = (gap_node_t) { start, end, end - start, -1, -1, hash };
+    return node;
+}
+
+// Gaps starting before key go to left, the others to right
+static void gap_split(gap_index_t* index, int node, int key, int* left, int* right) {
+    if (node < 0) {
+        *left = *right = -1;
+        return;
+    }
+    gap_node_t* n = &index->nodes[node];
+    if (n->start < key) {
+        gap_split(index, n->right, key, &n->right, right);
+        *left = node;
+    } else {
+        gap_split(index, n->left, key, left, &n->left);
+        *right = node;
+    }
+    gap_update(index, node);
+}
+
+// Every gap of left must start before every gap of right
+static int gap_merge(gap_index_t* index, int left, int right) {
+    if (left < 0) {
+        return right;
+    }
+    if (right < 0) {
+        return left;
+    }
+    if (index->nodes[left].priority > index->nodes[right].priority) {
+        index->nodes[left].right = gap_merge(index, index->nodes[left].right, right);
+        gap_update(index, left);
+        return left;
+    }
+    index->nodes[right].left = gap_merge(index, left, index->nodes[right].left);
+    gap_update(index, right);
+    return right;
+}
+
+// Earliest gap of at least duration, steered by the subtree maxima
+static int gap_first_fit(const gap_index_t* index, int node, int duration) {
+    if (gap_longest(index, node) < duration) {
+        return -1;
+    }
+    while (1) {
+        const gap_node_t* n = &index->nodes[node];
+        if (gap_longest(index, n->left) >= duration) {
+            node = n->left;
+        } else if (n->end - n->start >= duration) {
+            return node;
+        } else {
+            node = n->right;
+        }
+    }
+}
+
+// Earliest gap of at least duration starting after key: one walk along the
+// key's search path, then at most one first-fit descent, which cannot fail
+static int gap_fit_after(const gap_index_t* index, int node, int key, int duration) {
+    if (gap_longest(index, node) < duration) {
+        return -1;
+    }
+    const gap_node_t* n = &index->nodes[node];
+    if (n->start <= key) {
+        return gap_fit_after(index, n->right, key, duration);
+    }
+    int found = gap_fit_after(index, n->left, key, duration);
+    if (found >= 0) {
+        return found;
+    }
+    return n->end - n->start >= duration ? node : gap_first_fit(index, n->right, duration);
+}
+
+// Last gap starting at or before key, -1 if none
+static int gap_floor(const gap_index_t* index, int node, int key) {
+    int found = -1;
+    while (node >= 0) {
+        if (index->nodes[node].start <= key) {
+            found = node;
+            node = index->nodes[node].right;
+        } else {
+            node = index->nodes[node].left;
+        }
+    }
+    return found;
+}
+
+static int gap_insert(gap_index_t* index, int node, int inserted) {
+    if (node < 0) {
+        return inserted;
+    }
+    gap_node_t* n = &index->nodes[node];
+    gap_node_t* i = &index->nodes[inserted];
+    if (i->priority > n->priority) {
+        gap_split(index, node, i->start, &i->left, &i->right);
+        gap_update(index, inserted);
+        return inserted;
+    }
+    if (i->start < n->start) {
+        n->left = gap_insert(index, n->left, inserted);
+    } else {
+        n->right = gap_insert(index, n->right, inserted);
+    }
+    gap_update(index, node);
+    return node;
+}
+
+// Replaces the gap starting at key by [start, end), or removes it when the
+// new gap is empty; the new bounds lie within the old, so the order holds
+static int gap_resize(gap_index_t* index, int node, int key, int start, int end) {
+    gap_node_t* n = &index->nodes[node];
+    if (n->start == key) {
+        if (start == end) {
+            return gap_merge(index, n->left, n->right);
+        }
+        n->start = start;
+        n->end = end;
+    } else if (key < n->start) {
+        n->left = gap_resize(index, n->left, key, start, end);
+    } else {
+        n->right = gap_resize(index, n->right, key, start, end);
+    }
+    gap_update(index, node);
+    return node;
+}
+
+// Slow path of gap_index_place: the operation may fit before the machine's
+// last operation, or leaves a gap behind it
+int gap_index_fit(gap_index_t* index, int machine, int ready, int duration) {
+    int* root = &index->roots[machine];
+    int completion = index->completion[machine];
+    if (ready >= completion) {
+        // Gaps are disjoint and end by completion, so a new one goes last
+        if (ready > completion) {
+            *root = gap_insert(index, *root, gap_new(index, completion, ready));
+        }
+        index->completion[machine] = ready + duration;
+        return ready;
+    }
+
+    // Only the last gap starting at or before ready can hold ready itself;
+    // past it the earliest gap long enough wins
+    int chosen = gap_floor(index, *root, ready);
+    if (chosen < 0 || index->nodes[chosen].end - ready < duration) {
+        chosen = gap_fit_after(index, *root, ready, duration);
+    }
+    if (chosen < 0) {
+        index->completion[machine] = completion + duration;
+        return completion;
+    }
+
+    // The operation leaves up to one piece of the gap on either side
+    int gap_start = index->nodes[chosen].start;
+    int gap_end = index->nodes[chosen].end;
+    int start = max(gap_start, ready);
+    int end = start + duration;
+    if (start > gap_start) {
+        *root = gap_resize(index, *root, gap_start, gap_start, start);
+        if (gap_end > end) {
+            *root = gap_insert(index, *root, gap_new(index, end, gap_end));
+        }
+    } else {
+        *root = gap_resize(index, *root, gap_start, end, gap_end);
+    }
+    return start;
+}
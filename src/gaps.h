@@ -0,0 +1,60 @@
+#ifndef GAPS_H
+#define GAPS_H
+
+#include "arena.h"
+#include <stdint.h>
+
+// Idle interval [start, end) before the last operation of a machine, as a
+// treap node keyed by start; longest covers the node's whole subtree
+typedef struct {
+    int start;
+    int end;
+    int longest;
+    int left;
+    int right;
+    uint32_t priority;
+} gap_node_t;
+
+// Idle intervals of every machine in a schedule under construction. An
+// operation starts in the earliest gap that holds it from its ready time on,
+// found in one descent of its machine's treap, and only after the machine's
+// last operation when no gap is long enough. The schedules built are active:
+// no operation can start earlier without delaying another.
+typedef struct {
+    gap_node_t* nodes; // Pool for all machines, each placement takes at most one
+    int* roots; // Per machine, -1 without gaps
+    int* completion; // Per machine, end of its last operation
+    int num_machines;
+    int count;
+} gap_index_t;
+
+int gap_index_init(gap_index_t* index, arena_t* arena, int num_machines, int num_operations);
+void gap_index_reset(gap_index_t* index);
+int gap_index_fit(gap_index_t* index, int machine, int ready, int duration);
+
+// Start time of an operation of the given duration on machine, ready at ready,
+// which then occupies [start, start + duration)
+static inline int gap_index_place(gap_index_t* index, int machine, int ready, int duration) {
+    // Loaders reject negative times; should one get through, the operation
+    // only follows the machine's last one and leaves the gaps alone
+    if (duration < 0) {
+        int start = ready > index->completion[machine] ? ready : index->completion[machine];
+        if (start + duration > index->completion[machine]) {
+            index->completion[machine] = start + duration;
+        }
+        return start;
+    }
+    // At or past the machine's last operation no gap can be earlier
+    if (ready >= index->completion[machine]) {
+        return gap_index_fit(index, machine, ready, duration);
+    }
+    int root = index->roots[machine];
+    if (root < 0 || index->nodes[root].longest < duration) {
+        int start = index->completion[machine];
+        index->completion[machine] = start + duration;
+        return start;
+    }
+    return gap_index_fit(index, machine, ready, duration);
+}
+
+#endif
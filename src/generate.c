@@ -0,0 +1,71 @@
+#include "generate.h"
+#include "arena.h"
+#include "flowshop.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <stdio.h>
+
+// Taillard's generator (1993): the minimal standard LCG x = 16807 x mod
+// (2^31 - 1), computed with Schrage's decomposition so it never overflows 32
+// bits, and scaled to [low, high]. Seeds are in [1, 2^31 - 2].
+int taillard_uniform(int32_t* seed, int low, int high) {
+    const int32_t a = 16807;
+    const int32_t q = 127773; // m / a
+    const int32_t r = 2836; // m % a
+    int32_t k = *seed / q;
+    *seed = a * (*seed % q) - k * r;
+    if (*seed < 0) {
+        *seed += TAILLARD_MODULUS;
+    }
+    double value = (double)*seed / TAILLARD_MODULUS;
+    return low + (int)(value * (high - low + 1));
+}
+
+// Times U[1, 99] drawn job by job; job shop routes are the identity permuted
+// by swapping position j with a uniform position in [j, m), flow shop times
+// are drawn machine by machine. The published seeds reproduce ta01-ta80 and
+// Taillard's flow-shop set exactly.
+int generate_taillard(jobshop_t* jss, arena_t* arena, int num_jobs, int num_machines, int32_t time_seed,
+    int32_t machine_seed, int flow_shop) {
+    if (time_seed <= 0 || machine_seed <= 0 || time_seed == TAILLARD_MODULUS || machine_seed == TAILLARD_MODULUS) {
+        fprintf(stderr, "Error: Taillard seeds must be in [1, %d]\n", TAILLARD_MODULUS - 1);
+        return -1;
+    }
+    if (jobshop_init(jss, arena, num_jobs, num_machines) < 0) {
+        return -1;
+    }
+
+    if (flow_shop) {
+        for (int machine = 0; machine < num_machines; machine++) {
+            for (int job = 0; job < num_jobs; job++) {
+                int op = jobshop_op_index(jss, job, machine);
+                jss->times[op] = taillard_uniform(&time_seed, TAILLARD_MIN_TIME, TAILLARD_MAX_TIME);
+                jss->machines[op] = machine;
+            }
+        }
+    } else {
+        for (int op = 0; op < jss->num_operations; op++) {
+            jss->times[op] = taillard_uniform(&time_seed, TAILLARD_MIN_TIME, TAILLARD_MAX_TIME);
+        }
+        for (int job = 0; job < num_jobs; job++) {
+            int* route = jss->machines + jss->job_offsets[job];
+            for (int k = 0; k < num_machines; k++) {
+                route[k] = k;
+            }
+            for (int k = 0; k < num_machines; k++) {
+                int swap = taillard_uniform(&machine_seed, k, num_machines - 1);
+                int machine = route[k];
+                route[k] = route[swap];
+                route[swap] = machine;
+            }
+        }
+    }
+
+    int overflow = compute_remaining_work(jss);
+    if (overflow >= 0) {
+        fprintf(stderr, "Error: Job %d total time too large\n", overflow);
+        return -1;
+    }
+    jss->flow_shop = jobshop_is_flow_shop(jss);
+    return 0;
+}
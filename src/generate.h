@@ -0,0 +1,16 @@
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include "arena.h"
+#include "jobshop.h"
+#include <stdint.h>
+
+#define TAILLARD_MODULUS 2147483647 // 2^31 - 1
+#define TAILLARD_MIN_TIME 1
+#define TAILLARD_MAX_TIME 99
+
+int taillard_uniform(int32_t* seed, int low, int high);
+int generate_taillard(jobshop_t* jss, arena_t* arena, int num_jobs, int num_machines, int32_t time_seed,
+    int32_t machine_seed, int flow_shop);
+
+#endif
@@ -0,0 +1,330 @@
+#include "genetic.h"
+#include "affinity.h"
+#include "anytime.h"
+#include "arena.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include <limits.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Random streams above the rule pass, restarts and tabu search
+#define GA_STREAM_BASE 0x6a000000ULL
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Chromosome of a schedule: job ids in order of (start time, operation id)
+static int ga_encode(const jobshop_t* jss, const jobshop_solution_t* solution, int* genes) {
+    int n = jss->num_operations;
+    uint64_t* keys = malloc((size_t)n * sizeof(uint64_t));
+    if (!keys) {
+        return -1;
+    }
+    for (int op = 0; op < n; op++) {
+        keys[op] = ((uint64_t)(uint32_t)solution->schedule[op].start_time << 32) | (uint32_t)op;
+    }
+    qsort(keys, n, sizeof(uint64_t), compare_u64);
+
+    // Operations of a job are numbered in order, so a binary search on the
+    // offsets recovers the job
+    for (int i = 0; i < n; i++) {
+        int op = (int)(keys[i] & 0xffffffffu);
+        int lo = 0, hi = jss->num_jobs - 1;
+        while (lo < hi) {
+            int mid = (lo + hi + 1) / 2;
+            if (jss->job_offsets[mid] <= op) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        genes[i] = lo;
+    }
+    free(keys);
+    return 0;
+}
+
+static int ga_island_init(ga_island_t* island, const jobshop_t* jss, int population_size) {
+    size_t n = (size_t)jss->num_operations;
+    size_t p = (size_t)population_size;
+    arena_init(&island->arena, 0);
+    island->population_size = population_size;
+    island->genes = arena_alloc(&island->arena, p * n * sizeof(int));
+    island->next_genes = arena_alloc(&island->arena, p * n * sizeof(int));
+    island->makespans = arena_alloc(&island->arena, p * sizeof(int));
+    island->next_makespans = arena_alloc(&island->arena, p * sizeof(int));
+    island->migrant_genes = arena_alloc(&island->arena, GA_MIGRANTS * n * sizeof(int));
+    island->migrant_makespans = arena_alloc(&island->arena, GA_MIGRANTS * sizeof(int));
+    island->job_mask = arena_alloc(&island->arena, (size_t)jss->num_jobs);
+    if (!island->genes || !island->next_genes || !island->makespans || !island->next_makespans
+        || !island->migrant_genes || !island->migrant_makespans || !island->job_mask
+        || dispatch_scratch_init(&island->scratch, &island->arena, jss) < 0
+        || compact_solution_init(&island->decoded[0], &island->arena, jss) < 0
+        || compact_solution_init(&island->decoded[1], &island->arena, jss) < 0) {
+        return -1;
+    }
+    island->best = &island->decoded[0];
+    return 0;
+}
+
+// Decode one chromosome and keep the island's best schedule up to date
+static int ga_evaluate(ga_island_t* island, const jobshop_t* jss, const int* genes) {
+    compact_solution_t* current = island->best == &island->decoded[0] ? &island->decoded[1] : &island->decoded[0];
+    int makespan = dispatch_sequence(jss, current, genes, &island->scratch);
+    if (makespan < island->best->makespan) {
+        island->best = current;
+        anytime_publish(island->anytime, makespan, "genetic");
+    }
+    return makespan;
+}
+
+// Individual 0 is the incoming schedule, the rest are shuffles of it. Returns
+// -1 when the deadline cuts it short, leaving the population incomplete.
+static int ga_island_populate(ga_island_t* island, const jobshop_t* jss, const int* seed_genes) {
+    int n = jss->num_operations;
+    rng_t* rng = &island->scratch.rng;
+    for (int i = 0; i < island->population_size; i++) {
+        if (anytime_expired(island->anytime)) {
+            return -1;
+        }
+        int* genes = island->genes + (size_t)i * n;
+        memcpy(genes, seed_genes, (size_t)n * sizeof(int));
+        if (i > 0) {
+            for (int k = n - 1; k > 0; k--) {
+                int swap = rng_below(rng, k + 1);
+                int tmp = genes[k];
+                genes[k] = genes[swap];
+                genes[swap] = tmp;
+            }
+        }
+        island->makespans[i] = ga_evaluate(island, jss, genes);
+    }
+    return 0;
+}
+
+// Binary tournament, ties to the lower index
+static int ga_select(ga_island_t* island) {
+    int a = rng_below(&island->scratch.rng, island->population_size);
+    int b = rng_below(&island->scratch.rng, island->population_size);
+    if (island->makespans[b] < island->makespans[a] || (island->makespans[b] == island->makespans[a] && b < a)) {
+        return b;
+    }
+    return a;
+}
+
+// Precedence preserving order-based crossover: jobs in a random subset keep
+// their positions from the first parent, the others fill the remaining
+// positions in the order they appear in the second parent
+static void ga_crossover(ga_island_t* island, const jobshop_t* jss, const int* first, const int* second, int* child) {
+    rng_t* rng = &island->scratch.rng;
+    for (int job = 0; job < jss->num_jobs; job++) {
+        island->job_mask[job] = (unsigned char)(rng_next(rng) >> 63);
+    }
+
+    int n = jss->num_operations;
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        if (island->job_mask[first[i]]) {
+            child[i] = first[i];
+            continue;
+        }
+        while (island->job_mask[second[k]]) {
+            k++;
+        }
+        child[i] = second[k++];
+    }
+}
+
+static int ga_best_index(const ga_island_t* island, const int* exclude, int num_exclude) {
+    int best = -1;
+    for (int i = 0; i < island->population_size; i++) {
+        int excluded = 0;
+        for (int e = 0; e < num_exclude; e++) {
+            excluded |= exclude[e] == i;
+        }
+        if (!excluded && (best < 0 || island->makespans[i] < island->makespans[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static int ga_worst_index(const ga_island_t* island) {
+    int worst = 0;
+    for (int i = 1; i < island->population_size; i++) {
+        if (island->makespans[i] >= island->makespans[worst]) {
+            worst = i;
+        }
+    }
+    return worst;
+}
+
+// One generation: the best individual survives, every other slot is a child
+// of two tournament winners with an occasional swap mutation. The deadline is
+// polled per child, since one decode of a wide instance takes milliseconds;
+// a cut-short generation returns -1 and keeps the previous population.
+static int ga_generation(ga_island_t* island, const jobshop_t* jss) {
+    int n = jss->num_operations;
+    rng_t* rng = &island->scratch.rng;
+
+    int elite = ga_best_index(island, NULL, 0);
+    memcpy(island->next_genes, island->genes + (size_t)elite * n, (size_t)n * sizeof(int));
+    island->next_makespans[0] = island->makespans[elite];
+
+    for (int i = 1; i < island->population_size; i++) {
+        if (anytime_expired(island->anytime)) {
+            return -1;
+        }
+        const int* first = island->genes + (size_t)ga_select(island) * n;
+        const int* second = island->genes + (size_t)ga_select(island) * n;
+        int* child = island->next_genes + (size_t)i * n;
+        ga_crossover(island, jss, first, second, child);
+
+        if (rng_below(rng, 4) == 0) {
+            int a = rng_below(rng, n);
+            int b = rng_below(rng, n);
+            int tmp = child[a];
+            child[a] = child[b];
+            child[b] = tmp;
+        }
+        island->next_makespans[i] = ga_evaluate(island, jss, child);
+    }
+
+    int* genes = island->genes;
+    island->genes = island->next_genes;
+    island->next_genes = genes;
+    int* makespans = island->makespans;
+    island->makespans = island->next_makespans;
+    island->next_makespans = makespans;
+    return 0;
+}
+
+static void ga_emigrate(ga_island_t* island, const jobshop_t* jss) {
+    int n = jss->num_operations;
+    int chosen[GA_MIGRANTS];
+    for (int m = 0; m < GA_MIGRANTS && m < island->population_size; m++) {
+        chosen[m] = ga_best_index(island, chosen, m);
+        memcpy(island->migrant_genes + (size_t)m * n, island->genes + (size_t)chosen[m] * n, (size_t)n * sizeof(int));
+        island->migrant_makespans[m] = island->makespans[chosen[m]];
+    }
+}
+
+// Migrants replace the worst individuals they beat
+static void ga_immigrate(ga_island_t* island, const ga_island_t* source, const jobshop_t* jss) {
+    int n = jss->num_operations;
+    for (int m = 0; m < GA_MIGRANTS && m < source->population_size; m++) {
+        int worst = ga_worst_index(island);
+        if (source->migrant_makespans[m] < island->makespans[worst]) {
+            memcpy(island->genes + (size_t)worst * n, source->migrant_genes + (size_t)m * n, (size_t)n * sizeof(int));
+            island->makespans[worst] = source->migrant_makespans[m];
+        }
+    }
+}
+
+// Island-model genetic algorithm seeded with the current schedule, one island
+// per thread with elites migrating around a ring. Results depend on the seed
+// and the number of islands. The solution is only overwritten on improvement.
+int solve_genetic(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config) {
+    int num_islands = config->num_threads > 0 ? config->num_threads : 1;
+    int population_size = config->ga_population > 1 ? config->ga_population : 2;
+
+    // Nothing to do once the budget is spent, not even seeding the islands
+    if (anytime_expired(config->anytime)) {
+        return solution->makespan;
+    }
+
+    int* seed_genes = malloc((size_t)jss->num_operations * sizeof(int));
+    ga_island_t* islands = cache_aligned_calloc(num_islands, sizeof(ga_island_t));
+    int* failed = calloc(num_islands, sizeof(int));
+    if (!seed_genes || !islands || !failed || ga_encode(jss, solution, seed_genes) < 0) {
+        free(seed_genes);
+        free(islands);
+        free(failed);
+        return -1;
+    }
+
+    // The runtime may grant fewer threads than islands requested
+    int active = num_islands;
+    int stop = 0; // Raised by any island that sees the deadline or the bound
+    int leave = 0; // Agreed at a migration, so every island leaves together
+    int any_failed = 0;
+#pragma omp parallel num_threads(num_islands) reduction(| : any_failed)
+    {
+        // Each island is allocated and first touched by the thread that evolves
+        // it, and decodes against its node's replica of the instance
+        int id = omp_get_thread_num();
+        ga_island_t* island = &islands[id];
+        const jobshop_t* local = affinity_local_instance(jss);
+        failed[id] = ga_island_init(island, local, population_size) < 0;
+#pragma omp master
+        active = omp_get_num_threads();
+#pragma omp barrier
+        for (int i = 0; i < active; i++) {
+            any_failed |= failed[i];
+        }
+
+        if (!any_failed) {
+            island->anytime = config->anytime;
+            rng_seed(&island->scratch.rng, config->seed, GA_STREAM_BASE + (uint64_t)id);
+            int stopped = ga_island_populate(island, local, seed_genes) < 0;
+
+            // A stopped island skips its remaining generations, so it reaches
+            // the next migration within microseconds; there the islands agree
+            // to leave, and none is left waiting at a barrier
+            for (int g = 0; g < config->ga_generations; g++) {
+                if (!stopped) {
+                    stopped = __atomic_load_n(&stop, __ATOMIC_RELAXED) || ga_generation(island, local) < 0;
+                }
+                if (stopped) {
+                    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+                    if (active == 1) {
+                        break;
+                    }
+                }
+                if (active > 1 && (g + 1) % GA_MIGRATION_INTERVAL == 0) {
+                    if (!stopped) {
+                        ga_emigrate(island, local);
+                    }
+#pragma omp barrier
+#pragma omp single
+                    leave = __atomic_load_n(&stop, __ATOMIC_RELAXED);
+                    if (leave) {
+                        break;
+                    }
+                    ga_immigrate(island, &islands[(id + active - 1) % active], local);
+                    // Outboxes are rewritten only after every island has read its neighbour's
+#pragma omp barrier
+                }
+            }
+        }
+    }
+
+    int makespan = solution->makespan;
+    if (!any_failed) {
+        // Lowest makespan wins, ties to the lowest island
+        ga_island_t* winner = &islands[0];
+        for (int i = 1; i < active; i++) {
+            if (islands[i].best->makespan < winner->best->makespan) {
+                winner = &islands[i];
+            }
+        }
+        if (winner->best->makespan < makespan) {
+            winner->best->rule_used = solution->rule_used;
+            jobshop_solution_decode(solution, jss, winner->best);
+            makespan = solution->makespan;
+        }
+    }
+
+    for (int i = 0; i < num_islands; i++) {
+        arena_destroy(&islands[i].arena);
+    }
+    free(seed_genes);
+    free(islands);
+    free(failed);
+    return any_failed ? -1 : makespan;
+}
@@ -0,0 +1,35 @@
+#ifndef GENETIC_H
+#define GENETIC_H
+
+#include "arena.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include "utils.h"
+
+#define DEFAULT_GA_POPULATION 64 // Individuals per island
+#define GA_MIGRATION_INTERVAL 25 // Generations between migrations
+#define GA_MIGRANTS 2 // Elites sent to the next island on each migration
+
+// One island of the genetic algorithm. Chromosomes are operation-based
+// sequences of job ids stored row-major in one block, with fitness kept in a
+// separate array; everything is allocated before the generation loop.
+// Aligned so that neighbouring islands never share a cache line.
+typedef struct __attribute__((aligned(CACHE_LINE_SIZE))) {
+    arena_t arena;
+    dispatch_scratch_t scratch; // Decoder state and the island's random stream
+    compact_solution_t decoded[2]; // Best schedule so far and the one being decoded
+    compact_solution_t* best;
+    int population_size;
+    int* genes;
+    int* makespans;
+    int* next_genes;
+    int* next_makespans;
+    int* migrant_genes; // Outbox read by the next island in the ring
+    int* migrant_makespans;
+    unsigned char* job_mask; // Crossover job subset
+    anytime_t* anytime;
+} ga_island_t;
+
+int solve_genetic(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config);
+
+#endif
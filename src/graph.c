@@ -0,0 +1,174 @@
+#include "graph.h"
+#include "arena.h"
+#include "jobshop.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+int graph_init(schedule_graph_t* graph, arena_t* arena, const jobshop_t* jss) {
+    size_t n = (size_t)jss->num_operations;
+    graph->num_operations = jss->num_operations;
+    graph->num_machines = jss->num_machines;
+    graph->job_of = arena_alloc(arena, n * sizeof(int));
+    graph->machine_prev = arena_alloc(arena, n * sizeof(int));
+    graph->machine_next = arena_alloc(arena, n * sizeof(int));
+    graph->machine_first = arena_alloc(arena, (size_t)jss->num_machines * sizeof(int));
+    graph->heads = arena_alloc(arena, n * sizeof(int));
+    graph->tails = arena_alloc(arena, n * sizeof(int));
+    graph->order = arena_alloc(arena, n * sizeof(int));
+    graph->indegree = arena_alloc(arena, n * sizeof(int));
+    graph->makespan = 0;
+    if (!graph->job_of || !graph->machine_prev || !graph->machine_next || !graph->machine_first
+        || !graph->heads || !graph->tails || !graph->order || !graph->indegree) {
+        return -1;
+    }
+
+    for (int job = 0; job < jss->num_jobs; job++) {
+        for (int op = jss->job_offsets[job]; op < jss->job_offsets[job + 1]; op++) {
+            graph->job_of[op] = job;
+        }
+    }
+    return 0;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Machine sequences follow start times, ties broken by operation id
+int graph_from_solution(schedule_graph_t* graph, const jobshop_t* jss, const jobshop_solution_t* solution) {
+    int n = graph->num_operations;
+    uint64_t* keys = malloc((size_t)n * sizeof(uint64_t));
+    int* counts = calloc((size_t)jss->num_machines + 1, sizeof(int));
+    if (!keys || !counts) {
+        free(keys);
+        free(counts);
+        return -1;
+    }
+
+    // Bucket by machine, then sort each bucket by (start, op)
+    for (int op = 0; op < n; op++) {
+        counts[jss->machines[op] + 1]++;
+    }
+    for (int m = 0; m < jss->num_machines; m++) {
+        counts[m + 1] += counts[m];
+    }
+    for (int op = 0; op < n; op++) {
+        int slot = counts[jss->machines[op]]++;
+        keys[slot] = ((uint64_t)(uint32_t)solution->schedule[op].start_time << 32) | (uint32_t)op;
+    }
+
+    int begin = 0;
+    for (int m = 0; m < jss->num_machines; m++) {
+        int end = counts[m];
+        qsort(keys + begin, end - begin, sizeof(uint64_t), compare_u64);
+        int prev = -1;
+        graph->machine_first[m] = end > begin ? (int)(keys[begin] & 0xffffffffu) : -1;
+        for (int i = begin; i < end; i++) {
+            int op = (int)(keys[i] & 0xffffffffu);
+            graph->machine_prev[op] = prev;
+            if (prev >= 0) {
+                graph->machine_next[prev] = op;
+            }
+            prev = op;
+        }
+        if (prev >= 0) {
+            graph->machine_next[prev] = -1;
+        }
+        begin = end;
+    }
+
+    free(keys);
+    free(counts);
+    return 0;
+}
+
+// Longest-path heads and tails over a topological order; -1 on a cycle
+int graph_evaluate(schedule_graph_t* graph, const jobshop_t* jss) {
+    int n = graph->num_operations;
+    int count = 0;
+
+    for (int op = 0; op < n; op++) {
+        graph->indegree[op] = (graph_job_prev(graph, jss, op) >= 0) + (graph->machine_prev[op] >= 0);
+        graph->heads[op] = 0;
+        if (graph->indegree[op] == 0) {
+            graph->order[count++] = op;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        int op = graph->order[i];
+        int end = graph->heads[op] + jss->times[op];
+        int successors[2] = { graph_job_next(graph, jss, op), graph->machine_next[op] };
+        for (int k = 0; k < 2; k++) {
+            int succ = successors[k];
+            if (succ < 0) {
+                continue;
+            }
+            if (end > graph->heads[succ]) {
+                graph->heads[succ] = end;
+            }
+            if (--graph->indegree[succ] == 0) {
+                graph->order[count++] = succ;
+            }
+        }
+    }
+
+    if (count < n) {
+        return -1;
+    }
+
+    int makespan = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        int op = graph->order[i];
+        int tail = 0;
+        int successors[2] = { graph_job_next(graph, jss, op), graph->machine_next[op] };
+        for (int k = 0; k < 2; k++) {
+            int succ = successors[k];
+            if (succ >= 0 && jss->times[succ] + graph->tails[succ] > tail) {
+                tail = jss->times[succ] + graph->tails[succ];
+            }
+        }
+        graph->tails[op] = tail;
+        if (graph->heads[op] + jss->times[op] + tail > makespan) {
+            makespan = graph->heads[op] + jss->times[op] + tail;
+        }
+    }
+
+    graph->makespan = makespan;
+    return makespan;
+}
+
+void graph_to_solution(const schedule_graph_t* graph, const jobshop_t* jss, jobshop_solution_t* solution) {
+    solution->num_jobs = jss->num_jobs;
+    solution->num_machines = jss->num_machines;
+    solution->num_operations = jss->num_operations;
+    solution->job_offsets = jss->job_offsets;
+    for (int op = 0; op < graph->num_operations; op++) {
+        solution->schedule[op].machine_id = jss->machines[op];
+        solution->schedule[op].start_time = graph->heads[op];
+        solution->schedule[op].end_time = graph->heads[op] + jss->times[op];
+    }
+    solution->makespan = graph->makespan;
+}
+
+// Reverse the machine arc u -> v, u must directly precede v
+void graph_swap_adjacent(schedule_graph_t* graph, const jobshop_t* jss, int u, int v) {
+    int before = graph->machine_prev[u];
+    int after = graph->machine_next[v];
+
+    if (before >= 0) {
+        graph->machine_next[before] = v;
+    } else {
+        graph->machine_first[jss->machines[u]] = v;
+    }
+    if (after >= 0) {
+        graph->machine_prev[after] = u;
+    }
+
+    graph->machine_prev[v] = before;
+    graph->machine_next[v] = u;
+    graph->machine_prev[u] = v;
+    graph->machine_next[u] = after;
+}
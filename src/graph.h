@@ -0,0 +1,37 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "arena.h"
+#include "jobshop.h"
+
+// Disjunctive graph of a fixed machine sequencing. Operation ids are the flat
+// jobshop_t indices; job arcs are implicit (op - 1, op + 1 within a job).
+typedef struct {
+    int num_operations;
+    int num_machines;
+    int* job_of; // Owning job per operation
+    int* machine_prev; // -1 if first on its machine
+    int* machine_next; // -1 if last on its machine
+    int* machine_first; // First operation per machine, -1 if none
+    int* heads; // Earliest start (longest path from source)
+    int* tails; // Longest path from operation end to sink
+    int* order; // Topological order from the last evaluation
+    int* indegree; // Scratch for graph_evaluate
+    int makespan;
+} schedule_graph_t;
+
+int graph_init(schedule_graph_t* graph, arena_t* arena, const jobshop_t* jss);
+int graph_from_solution(schedule_graph_t* graph, const jobshop_t* jss, const jobshop_solution_t* solution);
+int graph_evaluate(schedule_graph_t* graph, const jobshop_t* jss);
+void graph_to_solution(const schedule_graph_t* graph, const jobshop_t* jss, jobshop_solution_t* solution);
+void graph_swap_adjacent(schedule_graph_t* graph, const jobshop_t* jss, int u, int v);
+
+static inline int graph_job_prev(const schedule_graph_t* graph, const jobshop_t* jss, int op) {
+    return op > jss->job_offsets[graph->job_of[op]] ? op - 1 : -1;
+}
+
+static inline int graph_job_next(const schedule_graph_t* graph, const jobshop_t* jss, int op) {
+    return op + 1 < jss->job_offsets[graph->job_of[op] + 1] ? op + 1 : -1;
+}
+
+#endif
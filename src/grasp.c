@@ -0,0 +1,154 @@
+#include "grasp.h"
+#include "affinity.h"
+#include "anytime.h"
+#include "arena.h"
+#include "dispatch.h"
+#include "instrument.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <limits.h>
+#include <omp.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static const dispatch_rule_t grasp_rules[] = {
+    SHORTEST_PROCESSING_TIME,
+    LONGEST_PROCESSING_TIME,
+    SHORTEST_REMAINING_TIME,
+    MOST_WORK_REMAINING,
+    FIRST_IN_FIRST_OUT,
+    MOST_OPERATIONS_REMAINING
+};
+
+int grasp_worker_init(grasp_worker_t* worker, const jobshop_t* jss) {
+    arena_init(&worker->arena, 0);
+    worker->best = NULL;
+    worker->best_restart = INT_MAX;
+    if (dispatch_scratch_init(&worker->scratch, &worker->arena, jss) < 0
+        || compact_solution_init(&worker->solutions[0], &worker->arena, jss) < 0
+        || compact_solution_init(&worker->solutions[1], &worker->arena, jss) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Restart r always uses rule r % rules and random stream DISPATCH_RULE_COUNT + r,
+// so the outcome depends only on the seed, not on how restarts are distributed
+void grasp_worker_run(grasp_worker_t* worker, const jobshop_t* jss, const solver_config_t* config,
+    int first, int last) {
+    int num_rules = sizeof(grasp_rules) / sizeof(grasp_rules[0]);
+    for (int r = first; r < last; r++) {
+        if (anytime_expired(config->anytime)) {
+            return;
+        }
+        compact_solution_t* current = worker->best == &worker->solutions[0] ? &worker->solutions[1] : &worker->solutions[0];
+        rng_seed(&worker->scratch.rng, config->seed, (uint64_t)DISPATCH_RULE_COUNT + r);
+        int makespan = dispatch_rollout(jss, current, grasp_rules[r % num_rules], config->rcl_size, &worker->scratch);
+
+        // Keep the local best by swapping buffers, never copying
+        if (!worker->best || makespan < worker->best->makespan
+            || (makespan == worker->best->makespan && r < worker->best_restart)) {
+            worker->best = current;
+            worker->best_restart = r;
+            anytime_publish(config->anytime, makespan, "grasp");
+        }
+    }
+}
+
+// Lower makespan wins, ties go to the lowest restart index
+int grasp_worker_better(const grasp_worker_t* a, const grasp_worker_t* b) {
+    if (!a->best) {
+        return 0;
+    }
+    if (!b->best) {
+        return 1;
+    }
+    return a->best->makespan < b->best->makespan
+        || (a->best->makespan == b->best->makespan && a->best_restart < b->best_restart);
+}
+
+void grasp_worker_destroy(grasp_worker_t* worker) {
+    arena_destroy(&worker->arena);
+}
+
+// Restarts per claim from the rollout cost: enough to amortise the shared
+// counter, few enough to balance threads and notice cancellation promptly
+static int grasp_chunk_size(int restarts, int num_threads, double rollout_seconds) {
+    int chunk = (int)(GRASP_CLAIM_SECONDS / rollout_seconds);
+    int balanced = restarts / (num_threads * GRASP_CLAIMS_PER_THREAD);
+    chunk = chunk < balanced ? chunk : balanced;
+    chunk = chunk < GRASP_MAX_CHUNK ? chunk : GRASP_MAX_CHUNK;
+    return chunk > 1 ? chunk : 1;
+}
+
+// Randomized multi-start over the deterministic rules, one worker per thread.
+// The solution is only overwritten when a restart improves on it.
+int solve_grasp(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config) {
+    double rollout_seconds = dispatch_rollout_seconds(jss);
+    int num_threads = config->num_threads > 1
+        ? get_optimal_thread_count(config->restarts, rollout_seconds, config->num_threads)
+        : 1;
+    int chunk = grasp_chunk_size(config->restarts, num_threads, rollout_seconds);
+    grasp_worker_t* workers = cache_aligned_calloc(num_threads, sizeof(grasp_worker_t));
+    int* failed = calloc(num_threads, sizeof(int));
+    if (!workers || !failed) {
+        free(workers);
+        free(failed);
+        return -1;
+    }
+
+    // Every thread claims once past the last chunk, so the counter is wider than
+    // the restart count
+    int64_t next_chunk = 0;
+#pragma omp parallel num_threads(num_threads)
+    {
+        int thread_id = omp_get_thread_num();
+        grasp_worker_t* local = &workers[thread_id];
+        const jobshop_t* instance = affinity_local_instance(jss);
+        int local_failed = grasp_worker_init(local, instance) < 0;
+        failed[thread_id] = local_failed;
+        INSTR_REGION_BEGIN(region);
+
+        // Dynamic scheduling by hand: chunks come from a shared counter, so on
+        // cancellation every thread leaves at once instead of draining a loop
+        while (!local_failed) {
+            int64_t first;
+#pragma omp atomic capture
+            first = next_chunk += chunk;
+            first -= chunk;
+            if (first >= config->restarts || anytime_expired(config->anytime)) {
+                break;
+            }
+            INSTR_BUSY_BEGIN(region);
+            int64_t last = first + chunk;
+            grasp_worker_run(local, instance, config, (int)first,
+                last < config->restarts ? (int)last : config->restarts);
+            INSTR_BUSY_END(region);
+        }
+
+#pragma omp barrier
+        INSTR_REGION_END(region);
+    }
+
+    grasp_worker_t* winner = NULL;
+    int any_failed = 0;
+    for (int t = 0; t < num_threads; t++) {
+        any_failed |= failed[t];
+        if (workers[t].best && (!winner || grasp_worker_better(&workers[t], winner))) {
+            winner = &workers[t];
+        }
+    }
+
+    int makespan = solution->makespan;
+    if (!any_failed && winner && (makespan <= 0 || winner->best->makespan < makespan)) {
+        jobshop_solution_decode(solution, jss, winner->best);
+        makespan = solution->makespan;
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        grasp_worker_destroy(&workers[t]);
+    }
+    free(workers);
+    free(failed);
+    return any_failed ? -1 : makespan;
+}
@@ -0,0 +1,32 @@
+#ifndef GRASP_H
+#define GRASP_H
+
+#include "arena.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include "utils.h"
+
+#define GRASP_MAX_CHUNK 64 // Most restarts a worker claims at a time
+#define GRASP_CLAIM_SECONDS 200e-6 // Work per claim that amortises the shared counter
+#define GRASP_CLAIMS_PER_THREAD 8 // Claims per thread kept available for balancing
+
+// One worker's share of the restarts, with its own scratch and two compact
+// schedule buffers so the local best is tracked by pointer swap. Aligned so
+// that workers in an array never share a cache line.
+typedef struct __attribute__((aligned(CACHE_LINE_SIZE))) {
+    arena_t arena;
+    dispatch_scratch_t scratch;
+    compact_solution_t solutions[2];
+    compact_solution_t* best;
+    int best_restart;
+} grasp_worker_t;
+
+int grasp_worker_init(grasp_worker_t* worker, const jobshop_t* jss);
+void grasp_worker_run(grasp_worker_t* worker, const jobshop_t* jss, const solver_config_t* config,
+    int first, int last);
+int grasp_worker_better(const grasp_worker_t* a, const grasp_worker_t* b);
+void grasp_worker_destroy(grasp_worker_t* worker);
+
+int solve_grasp(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config);
+
+#endif
@@ -0,0 +1,315 @@
+#include "instance.h"
+#include "arena.h"
+#include "flowshop.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define JSSB_HOST_LITTLE_ENDIAN 0
+#else
+#define JSSB_HOST_LITTLE_ENDIAN 1
+#endif
+
+typedef struct {
+    const char* pos;
+    const char* end;
+} text_cursor_t;
+
+static inline int is_blank(char c) {
+    return c == ' ' || (unsigned)(c - '\t') <= (unsigned)('\r' - '\t');
+}
+
+// Skip whitespace and # comments (to end of line) before the next token
+static inline void skip_blank(text_cursor_t* cursor) {
+    const char* pos = cursor->pos;
+    const char* end = cursor->end;
+    while (pos < end) {
+        if (*pos == '#') {
+            const char* newline = memchr(pos, '\n', (size_t)(end - pos));
+            pos = newline ? newline + 1 : end;
+        } else if (is_blank(*pos)) {
+            pos++;
+        } else {
+            break;
+        }
+    }
+    cursor->pos = pos;
+}
+
+// Parses the next integer in place: 1 on success, 0 at end of input, -1 if
+// the token is not an integer or does not fit in an int. Digits are tested
+// with a single unsigned compare, which compilers turn into branch-free code.
+static inline int next_int(text_cursor_t* cursor, int* value) {
+    skip_blank(cursor);
+    const char* pos = cursor->pos;
+    const char* end = cursor->end;
+    if (pos == end) {
+        return 0;
+    }
+
+    int negative = *pos == '-';
+    pos += negative;
+    const char* digits = pos;
+    long long result = 0;
+    while (pos < end && (unsigned)(*pos - '0') < 10u) {
+        result = result * 10 + (*pos - '0');
+        if (result > INT_MAX) {
+            return -1;
+        }
+        pos++;
+    }
+    if (pos == digits || (pos < end && !is_blank(*pos) && *pos != '#')) {
+        return -1;
+    }
+    cursor->pos = pos;
+    *value = negative ? -(int)result : (int)result;
+    return 1;
+}
+
+// Tokenizes the whole mapping in one pass; line length is irrelevant, so
+// arbitrarily wide instances parse the same as narrow ones
+int parse_jobshop_text(const char* data, size_t length, const char* filename, jobshop_t* jss, arena_t* arena) {
+    text_cursor_t cursor = { data, data + length };
+    int num_jobs = 0;
+    int num_machines = 0;
+    if (next_int(&cursor, &num_jobs) != 1 || next_int(&cursor, &num_machines) != 1) {
+        fprintf(stderr, "Error: Missing '<num_jobs> <num_machines>' header in '%s'\n", filename);
+        return -1;
+    }
+
+    if (jobshop_init(jss, arena, num_jobs, num_machines) < 0) {
+        return -1;
+    }
+
+    for (int job = 0; job < jss->num_jobs; job++) {
+        for (int op = 0; op < jss->num_machines; op++) {
+            int idx = jobshop_op_index(jss, job, op);
+            if (next_int(&cursor, &jss->machines[idx]) != 1) {
+                fprintf(stderr,
+                    "Error: Missing machine for job %d, operation %d\n",
+                    job, op);
+                return -1;
+            }
+            if (jss->machines[idx] < 0 || jss->machines[idx] >= jss->num_machines) {
+                fprintf(stderr,
+                    "Error: Invalid machine %d for job %d, operation %d\n",
+                    jss->machines[idx], job, op);
+                return -1;
+            }
+
+            if (next_int(&cursor, &jss->times[idx]) != 1) {
+                fprintf(stderr,
+                    "Error: Missing time for job %d, operation %d\n", job,
+                    op);
+                return -1;
+            }
+            if (jss->times[idx] < 0) {
+                fprintf(stderr,
+                    "Error: Negative time %d for job %d, operation %d\n",
+                    jss->times[idx], job, op);
+                return -1;
+            }
+        }
+    }
+
+    int overflow = compute_remaining_work(jss);
+    if (overflow >= 0) {
+        fprintf(stderr, "Error: Job %d total time too large in '%s'\n", overflow, filename);
+        return -1;
+    }
+    jss->flow_shop = jobshop_is_flow_shop(jss);
+    return 0;
+}
+
+static uint32_t read_le32(const unsigned char* bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static uint64_t read_le64(const unsigned char* bytes) {
+    return (uint64_t)read_le32(bytes) | (uint64_t)read_le32(bytes + 4) << 32;
+}
+
+static void write_le32(unsigned char* bytes, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void write_le64(unsigned char* bytes, uint64_t value) {
+    write_le32(bytes, (uint32_t)value);
+    write_le32(bytes + 4, (uint32_t)(value >> 32));
+}
+
+// FNV-1a over 32-bit words rather than bytes, four times fewer multiplies
+static uint64_t jssb_checksum_update(uint64_t hash, const int* values, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        hash = (hash ^ (uint32_t)values[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t jobshop_checksum(const jobshop_t* jss) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = jssb_checksum_update(hash, jss->machines, (size_t)jss->num_operations);
+    hash = jssb_checksum_update(hash, jss->times, (size_t)jss->num_operations);
+    return jssb_checksum_update(hash, jss->remaining_work, (size_t)jss->num_operations);
+}
+
+// On little-endian hosts the arrays are used straight from the mapping; the
+// caller hands the mapping to the arena. Big-endian hosts get swapped copies.
+int load_jobshop_binary(const void* data, size_t length, const char* filename, jobshop_t* jss, arena_t* arena) {
+    const unsigned char* bytes = data;
+    if (length < JSSB_HEADER_SIZE || memcmp(bytes, JSSB_MAGIC, 4) != 0) {
+        fprintf(stderr, "Error: '%s' is not a binary instance\n", filename);
+        return -1;
+    }
+    uint32_t version = read_le32(bytes + 4);
+    int num_jobs = (int)read_le32(bytes + 8);
+    int num_machines = (int)read_le32(bytes + 12);
+    uint64_t checksum = read_le64(bytes + 16);
+    if (version != JSSB_VERSION) {
+        fprintf(stderr, "Error: Unsupported binary instance version %u in '%s'\n", version, filename);
+        return -1;
+    }
+    if (num_jobs <= 0 || num_machines <= 0 || num_jobs > INT_MAX / num_machines) {
+        fprintf(stderr, "Error: Invalid number of jobs (%d) or machines (%d)\n", num_jobs, num_machines);
+        return -1;
+    }
+    size_t n = (size_t)num_jobs * (size_t)num_machines;
+    if ((length - JSSB_HEADER_SIZE) / (3 * sizeof(int32_t)) < n) {
+        fprintf(stderr, "Error: Truncated binary instance '%s'\n", filename);
+        return -1;
+    }
+
+    jss->num_jobs = num_jobs;
+    jss->num_machines = num_machines;
+    jss->num_operations = (int)n;
+    jss->job_offsets = arena_alloc(arena, (size_t)(num_jobs + 1) * sizeof(int));
+    if (!jss->job_offsets) {
+        fprintf(stderr, "Error: Out of memory allocating %dx%d instance\n", num_jobs, num_machines);
+        return -1;
+    }
+    for (int job = 0; job <= num_jobs; job++) {
+        jss->job_offsets[job] = job * num_machines;
+    }
+
+    const int32_t* arrays = (const int32_t*)(bytes + JSSB_HEADER_SIZE);
+    if (JSSB_HOST_LITTLE_ENDIAN) {
+        jss->machines = (int*)arrays;
+        jss->times = (int*)arrays + n;
+        jss->remaining_work = (int*)arrays + 2 * n;
+    } else {
+        int* copy = arena_alloc(arena, 3 * n * sizeof(int));
+        if (!copy) {
+            fprintf(stderr, "Error: Out of memory allocating %dx%d instance\n", num_jobs, num_machines);
+            return -1;
+        }
+        for (size_t i = 0; i < 3 * n; i++) {
+            copy[i] = (int)read_le32((const unsigned char*)(arrays + i));
+        }
+        jss->machines = copy;
+        jss->times = copy + n;
+        jss->remaining_work = copy + 2 * n;
+    }
+
+    if (jobshop_checksum(jss) != checksum) {
+        fprintf(stderr, "Error: Checksum mismatch in binary instance '%s'\n", filename);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if ((unsigned)jss->machines[i] >= (unsigned)num_machines) {
+            fprintf(stderr, "Error: Invalid machine %d at operation %zu of '%s'\n", jss->machines[i], i, filename);
+            return -1;
+        }
+        if (jss->times[i] < 0) {
+            fprintf(stderr, "Error: Negative time %d at operation %zu of '%s'\n", jss->times[i], i, filename);
+            return -1;
+        }
+    }
+    // The checksum is unkeyed, so a sender can make it match any arrays; wrong
+    // suffix sums would skew the MWR/SRT rules and the lower bound
+    for (int job = 0; job < num_jobs; job++) {
+        long long work = 0;
+        for (int op = jss->job_offsets[job + 1] - 1; op >= jss->job_offsets[job]; op--) {
+            work += jss->times[op];
+            if (work > INT_MAX) {
+                fprintf(stderr, "Error: Job %d total time too large in '%s'\n", job, filename);
+                return -1;
+            }
+            if (jss->remaining_work[op] != work) {
+                fprintf(stderr, "Error: Invalid remaining work %d at operation %d of '%s'\n",
+                    jss->remaining_work[op], op, filename);
+                return -1;
+            }
+        }
+    }
+    jss->flow_shop = jobshop_is_flow_shop(jss);
+    return 0;
+}
+
+static int write_le32_array(FILE* file, const int* values, size_t count) {
+    if (JSSB_HOST_LITTLE_ENDIAN) {
+        return fwrite(values, sizeof(int), count, file) == count ? 0 : -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        unsigned char bytes[4];
+        write_le32(bytes, (uint32_t)values[i]);
+        if (fwrite(bytes, 1, 4, file) != 4) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Same layout as the data/ instances: a header line, then one line of
+// machine and time pairs per job
+int write_jobshop_text(const char* filename, const jobshop_t* jss) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
+        return -1;
+    }
+
+    fprintf(file, "%d %d\n", jss->num_jobs, jss->num_machines);
+    for (int job = 0; job < jss->num_jobs; job++) {
+        for (int op = jss->job_offsets[job]; op < jss->job_offsets[job + 1]; op++) {
+            fprintf(file, "%s%d %d", op > jss->job_offsets[job] ? "  " : "", jss->machines[op], jss->times[op]);
+        }
+        fputc('\n', file);
+    }
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) {
+        fprintf(stderr, "Error: Failed to write instance '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+int write_jobshop_binary(const char* filename, const jobshop_t* jss) {
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
+        return -1;
+    }
+
+    unsigned char header[JSSB_HEADER_SIZE] = { 0 };
+    memcpy(header, JSSB_MAGIC, 4);
+    write_le32(header + 4, JSSB_VERSION);
+    write_le32(header + 8, (uint32_t)jss->num_jobs);
+    write_le32(header + 12, (uint32_t)jss->num_machines);
+    write_le64(header + 16, jobshop_checksum(jss));
+
+    size_t n = (size_t)jss->num_operations;
+    int failed = fwrite(header, 1, sizeof(header), file) != sizeof(header)
+        || write_le32_array(file, jss->machines, n) < 0
+        || write_le32_array(file, jss->times, n) < 0
+        || write_le32_array(file, jss->remaining_work, n) < 0;
+    if (fclose(file) != 0 || failed) {
+        fprintf(stderr, "Error: Failed to write binary instance '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include "arena.h"
+#include "jobshop.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary instance format (.jssb), all fields little-endian:
+//   char     magic[4]    "JSSB"
+//   uint32   version     JSSB_VERSION
+//   int32    num_jobs
+//   int32    num_machines
+//   uint64   checksum    over the three arrays, see jobshop_checksum
+//   uint64   reserved    0
+//   int32    machines[num_jobs * num_machines]
+//   int32    times[num_jobs * num_machines]
+//   int32    remaining_work[num_jobs * num_machines]
+#define JSSB_MAGIC "JSSB"
+#define JSSB_VERSION 1
+#define JSSB_HEADER_SIZE 32
+
+int parse_jobshop_text(const char* data, size_t length, const char* filename, jobshop_t* jss, arena_t* arena);
+int load_jobshop_binary(const void* data, size_t length, const char* filename, jobshop_t* jss, arena_t* arena);
+int write_jobshop_text(const char* filename, const jobshop_t* jss);
+int write_jobshop_binary(const char* filename, const jobshop_t* jss);
+uint64_t jobshop_checksum(const jobshop_t* jss);
+
+#endif
@@ -0,0 +1,220 @@
+#define _GNU_SOURCE
+#include "instrument.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <stdio.h>
+
+#ifdef JSS_INSTRUMENT
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define INSTR_MAX_THREADS 256
+
+typedef struct {
+    long rollouts;
+    long priority_evaluations;
+    long ready_steps;
+    long ready_size_sum;
+    int ready_size_max;
+    double seconds;
+    uint64_t perf[INSTR_PERF_COUNTERS];
+} instr_rule_stats_t;
+
+// One slot per OS thread, padded so threads never share a cache line
+typedef struct {
+    instr_rule_stats_t rules[DISPATCH_RULE_COUNT];
+    double region_seconds;
+    double busy_seconds;
+    long regions;
+    int used;
+} __attribute__((aligned(64))) instr_thread_stats_t;
+
+static instr_thread_stats_t instr_slots[INSTR_MAX_THREADS];
+static int instr_num_slots = 0;
+static int instr_perf_available = 0;
+
+// Slot and perf group of the calling thread, set up on first use
+static __thread int instr_slot = -1;
+static __thread int instr_perf_fd = -2;
+
+static const char* instr_perf_names[INSTR_PERF_COUNTERS] = { "cycles", "cache_misses", "branch_misses" };
+static const uint64_t instr_perf_configs[INSTR_PERF_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static double instr_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static instr_thread_stats_t* instr_thread_stats(void) {
+    if (instr_slot < 0) {
+        int slot;
+#pragma omp atomic capture
+        slot = instr_num_slots++;
+        instr_slot = slot < INSTR_MAX_THREADS ? slot : INSTR_MAX_THREADS - 1;
+        instr_slots[instr_slot].used = 1;
+    }
+    return &instr_slots[instr_slot];
+}
+
+// Counter group for this thread on any CPU; silently absent when perf events
+// are not permitted (e.g. perf_event_paranoid or containers)
+static void instr_perf_open(void) {
+    int leader = -1;
+    for (int i = 0; i < INSTR_PERF_COUNTERS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = instr_perf_configs[i];
+        attr.disabled = leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd < 0) {
+            if (leader >= 0) {
+                close(leader);
+            }
+            instr_perf_fd = -1;
+            return;
+        }
+        if (leader < 0) {
+            leader = fd;
+        }
+    }
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    instr_perf_fd = leader;
+#pragma omp atomic write
+    instr_perf_available = 1;
+}
+
+static void instr_perf_read(uint64_t* values) {
+    if (instr_perf_fd == -2) {
+        instr_perf_open();
+    }
+    uint64_t buffer[1 + INSTR_PERF_COUNTERS];
+    if (instr_perf_fd < 0 || read(instr_perf_fd, buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer)) {
+        memset(values, 0, INSTR_PERF_COUNTERS * sizeof(uint64_t));
+        return;
+    }
+    memcpy(values, buffer + 1, INSTR_PERF_COUNTERS * sizeof(uint64_t));
+}
+
+void instr_rollout_begin(instr_rollout_t* rollout) {
+    memset(rollout, 0, sizeof(*rollout));
+    instr_perf_read(rollout->perf_start);
+    rollout->start = instr_now();
+}
+
+void instr_rollout_end(instr_rollout_t* rollout, dispatch_rule_t rule) {
+    double seconds = instr_now() - rollout->start;
+    uint64_t perf_end[INSTR_PERF_COUNTERS];
+    instr_perf_read(perf_end);
+
+    instr_rule_stats_t* stats = &instr_thread_stats()->rules[rule];
+    stats->rollouts++;
+    stats->priority_evaluations += rollout->priority_evaluations;
+    stats->ready_steps += rollout->ready_steps;
+    stats->ready_size_sum += rollout->ready_size_sum;
+    if (rollout->ready_size_max > stats->ready_size_max) {
+        stats->ready_size_max = rollout->ready_size_max;
+    }
+    stats->seconds += seconds;
+    for (int i = 0; i < INSTR_PERF_COUNTERS; i++) {
+        stats->perf[i] += perf_end[i] - rollout->perf_start[i];
+    }
+}
+
+void instr_region_begin(instr_region_t* region) {
+    region->region_start = instr_now();
+    region->busy_start = 0.0;
+}
+
+void instr_busy_begin(instr_region_t* region) {
+    region->busy_start = instr_now();
+}
+
+void instr_busy_end(instr_region_t* region) {
+    instr_thread_stats()->busy_seconds += instr_now() - region->busy_start;
+}
+
+// Called after the worksharing barrier, so barrier waits count as idle time
+void instr_region_end(instr_region_t* region) {
+    instr_thread_stats_t* stats = instr_thread_stats();
+    stats->region_seconds += instr_now() - region->region_start;
+    stats->regions++;
+}
+
+int instrument_enabled(void) {
+    return 1;
+}
+
+int instrument_write_trace(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
+        return -1;
+    }
+
+    fprintf(file, "{\n  \"perf_counters\": %s,\n  \"threads\": [", instr_perf_available ? "true" : "false");
+    int first_thread = 1;
+    for (int t = 0; t < instr_num_slots && t < INSTR_MAX_THREADS; t++) {
+        const instr_thread_stats_t* slot = &instr_slots[t];
+        if (!slot->used) {
+            continue;
+        }
+        fprintf(file, "%s\n    {\"thread\": %d, \"regions\": %ld, \"region_s\": %.9f, \"busy_s\": %.9f, \"idle_s\": %.9f, \"rules\": [",
+            first_thread ? "" : ",", t, slot->regions, slot->region_seconds, slot->busy_seconds,
+            slot->region_seconds > slot->busy_seconds ? slot->region_seconds - slot->busy_seconds : 0.0);
+        first_thread = 0;
+
+        int first_rule = 1;
+        for (int r = 0; r < DISPATCH_RULE_COUNT; r++) {
+            const instr_rule_stats_t* stats = &slot->rules[r];
+            if (stats->rollouts == 0) {
+                continue;
+            }
+            fprintf(file, "%s\n      {\"rule\": \"%s\", \"rollouts\": %ld, \"seconds\": %.9f, "
+                          "\"priority_evaluations\": %ld, \"steps\": %ld, \"mean_ready\": %.3f, \"max_ready\": %d",
+                first_rule ? "" : ",", dispatch_rule_name(r), stats->rollouts, stats->seconds,
+                stats->priority_evaluations, stats->ready_steps,
+                stats->ready_steps ? (double)stats->ready_size_sum / stats->ready_steps : 0.0, stats->ready_size_max);
+            if (instr_perf_available) {
+                for (int i = 0; i < INSTR_PERF_COUNTERS; i++) {
+                    fprintf(file, ", \"%s\": %llu", instr_perf_names[i], (unsigned long long)stats->perf[i]);
+                }
+            }
+            fprintf(file, "}");
+            first_rule = 0;
+        }
+        fprintf(file, "%s]}", first_rule ? "" : "\n    ");
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    fclose(file);
+    return 0;
+}
+
+#else
+
+int instrument_enabled(void) {
+    return 0;
+}
+
+int instrument_write_trace(const char* filename) {
+    fprintf(stderr, "Error: Cannot write trace '%s', rebuild with INSTRUMENT=1\n", filename);
+    return -1;
+}
+
+#endif
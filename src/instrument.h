@@ -0,0 +1,71 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include "jobshop.h"
+#include <stdint.h>
+
+// Hot-path instrumentation, compiled in with `make build INSTRUMENT=1`
+// (-DJSS_INSTRUMENT). Without it every INSTR_* macro expands to nothing.
+
+int instrument_enabled(void);
+int instrument_write_trace(const char* filename);
+
+#ifdef JSS_INSTRUMENT
+
+#define INSTR_PERF_COUNTERS 3 // cycles, cache misses, branch misses
+
+typedef struct {
+    long priority_evaluations;
+    long ready_steps;
+    long ready_size_sum;
+    int ready_size_max;
+    double start;
+    uint64_t perf_start[INSTR_PERF_COUNTERS];
+} instr_rollout_t;
+
+typedef struct {
+    double region_start;
+    double busy_start;
+} instr_region_t;
+
+void instr_rollout_begin(instr_rollout_t* rollout);
+void instr_rollout_end(instr_rollout_t* rollout, dispatch_rule_t rule);
+void instr_region_begin(instr_region_t* region);
+void instr_busy_begin(instr_region_t* region);
+void instr_busy_end(instr_region_t* region);
+void instr_region_end(instr_region_t* region);
+
+#define INSTR_ROLLOUT_BEGIN(r) \
+    instr_rollout_t r;         \
+    instr_rollout_begin(&r)
+#define INSTR_READY_SET(r, size)                \
+    do {                                        \
+        (r).ready_steps++;                      \
+        (r).ready_size_sum += (size);           \
+        if ((size) > (r).ready_size_max) {      \
+            (r).ready_size_max = (size);        \
+        }                                       \
+    } while (0)
+#define INSTR_PRIORITY_EVALS(r, n) ((r).priority_evaluations += (n))
+#define INSTR_ROLLOUT_END(r, rule) instr_rollout_end(&(r), (rule))
+#define INSTR_REGION_BEGIN(t) \
+    instr_region_t t;         \
+    instr_region_begin(&t)
+#define INSTR_BUSY_BEGIN(t) instr_busy_begin(&(t))
+#define INSTR_BUSY_END(t) instr_busy_end(&(t))
+#define INSTR_REGION_END(t) instr_region_end(&(t))
+
+#else
+
+#define INSTR_ROLLOUT_BEGIN(r) ((void)0)
+#define INSTR_READY_SET(r, size) ((void)0)
+#define INSTR_PRIORITY_EVALS(r, n) ((void)0)
+#define INSTR_ROLLOUT_END(r, rule) ((void)0)
+#define INSTR_REGION_BEGIN(t) ((void)0)
+#define INSTR_BUSY_BEGIN(t) ((void)0)
+#define INSTR_BUSY_END(t) ((void)0)
+#define INSTR_REGION_END(t) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+#include "jobshop.h"
+#include "arena.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+int jobshop_init(jobshop_t* jss, arena_t* arena, int num_jobs, int num_machines) {
+    if (num_jobs <= 0 || num_machines <= 0 || num_jobs > INT_MAX / num_machines) {
+        fprintf(stderr, "Error: Invalid number of jobs (%d) or machines (%d)\n",
+            num_jobs, num_machines);
+        return -1;
+    }
+
+    jss->num_jobs = num_jobs;
+    jss->num_machines = num_machines;
+    jss->num_operations = num_jobs * num_machines;
+    jss->job_offsets = arena_alloc(arena, (size_t)(num_jobs + 1) * sizeof(int));
+    jss->machines = arena_alloc(arena, (size_t)jss->num_operations * sizeof(int));
+    jss->times = arena_alloc(arena, (size_t)jss->num_operations * sizeof(int));
+    jss->remaining_work = arena_alloc(arena, (size_t)jss->num_operations * sizeof(int));
+    if (!jss->job_offsets || !jss->machines || !jss->times || !jss->remaining_work) {
+        fprintf(stderr, "Error: Out of memory allocating %dx%d instance\n", num_jobs, num_machines);
+        return -1;
+    }
+
+    for (int job = 0; job <= num_jobs; job++) {
+        jss->job_offsets[job] = job * num_machines;
+    }
+    return 0;
+}
+
+int jobshop_solution_init(jobshop_solution_t* solution, arena_t* arena, const jobshop_t* jss) {
+    solution->num_jobs = jss->num_jobs;
+    solution->num_machines = jss->num_machines;
+    solution->num_operations = jss->num_operations;
+    solution->makespan = 0;
+    solution->rule_used = FIRST_IN_FIRST_OUT;
+    solution->job_offsets = jss->job_offsets;
+    solution->schedule = arena_calloc(arena, jss->num_operations, sizeof(operation_schedule_t));
+    if (!solution->schedule) {
+        fprintf(stderr, "Error: Out of memory allocating solution\n");
+        return -1;
+    }
+    return 0;
+}
+
+void jobshop_solution_copy(jobshop_solution_t* dst, const jobshop_solution_t* src) {
+    dst->num_jobs = src->num_jobs;
+    dst->num_machines = src->num_machines;
+    dst->num_operations = src->num_operations;
+    dst->makespan = src->makespan;
+    dst->rule_used = src->rule_used;
+    dst->job_offsets = src->job_offsets;
+    memcpy(dst->schedule, src->schedule, (size_t)src->num_operations * sizeof(operation_schedule_t));
+}
+
+int compact_solution_init(compact_solution_t* compact, arena_t* arena, const jobshop_t* jss) {
+    compact->makespan = INT_MAX;
+    compact->rule_used = FIRST_IN_FIRST_OUT;
+    compact->start = arena_alloc(arena, (size_t)jss->num_operations * sizeof(int));
+    if (!compact->start) {
+        fprintf(stderr, "Error: Out of memory allocating solution\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Runs back to front, so compact->start may live inside solution->schedule:
+// entry op only overwrites ints at or after index op, which are already read
+void jobshop_solution_decode(jobshop_solution_t* solution, const jobshop_t* jss, const compact_solution_t* compact) {
+    solution->num_jobs = jss->num_jobs;
+    solution->num_machines = jss->num_machines;
+    solution->num_operations = jss->num_operations;
+    solution->job_offsets = jss->job_offsets;
+    solution->makespan = compact->makespan;
+    solution->rule_used = compact->rule_used;
+    for (int op = jss->num_operations - 1; op >= 0; op--) {
+        int start = compact->start[op];
+        solution->schedule[op].machine_id = jss->machines[op];
+        solution->schedule[op].start_time = start;
+        solution->schedule[op].end_time = start + jss->times[op];
+    }
+}
@@ -1,15 +1,24 @@
 #ifndef JOBSHOP_H
 #define JOBSHOP_H
 
-#define MAX_JOBS 100
-#define MAX_MACHINES 100
+#include "anytime.h"
+#include "arena.h"
+#include <stdint.h>
+
 #define MAX_LINE_LENGTH 1024
 
+// Operations are stored job-major in flat arrays; the operations of job j
+// occupy [job_offsets[j], job_offsets[j + 1])
 typedef struct {
     int num_jobs;
     int num_machines;
-    int machines[MAX_JOBS][MAX_MACHINES];
-    int times[MAX_JOBS][MAX_MACHINES];
+    int num_operations;
+    int* job_offsets;
+    int* machines;
+    int* times;
+    // Suffix sums of times per job, remaining_work[i] = sum(times[i..end of job])
+    int* remaining_work;
+    int flow_shop; // Every job visits the same machines in the same order
 } jobshop_t;
 
 typedef enum {
@@ -18,19 +27,26 @@ typedef enum {
     MODE_PARALLEL = 2
 } execution_mode_t;
 
+typedef struct {
+    int num_threads;
+    uint64_t seed; // Root of every random stream, equal seeds give equal results
+    int restarts; // Randomized greedy rollouts after the rule pass, 0 disables
+    int rcl_size; // Restricted candidate list size for randomized rollouts
+    int tabu_iterations; // Tabu search improvement of the best schedule, 0 disables
+    int tabu_parallel; // Evaluate tabu neighbourhoods across num_threads
+    int ga_generations; // Island genetic algorithm generations, 0 disables
+    int ga_population; // Individuals per island
+    int ig_iterations; // Iterated greedy steps per thread on flow shops, 0 disables
+    anytime_t* anytime; // Deadline and shared incumbent, NULL when unlimited
+    const struct jobshop_solution* warm_start; // Replaces the rule pass when set
+} solver_config_t;
+
 typedef struct {
     int machine_id;
     int start_time;
     int end_time;
 } operation_schedule_t;
 
-typedef struct {
-    int num_jobs;
-    int num_machines;
-    int makespan;
-    operation_schedule_t schedule[MAX_JOBS][MAX_MACHINES];
-} jobshop_solution_t;
-
 // dispatch_rule_t rules[] = {
 //     SHORTEST_PROCESSING_TIME,
 //     LONGEST_PROCESSING_TIME,
@@ -41,31 +57,79 @@ typedef struct {
 //     RANDOM                        // NEW - good for testing
 // };
 
+// Every dispatch rule as X(rule, name, priority): the priority of job_id's
+// next operation op (op_idx within the job), lower dispatched first, ties to
+// the lower job id. Adding a rule takes one line here; dispatch.c generates a
+// specialized rollout kernel for each entry.
+#define DISPATCH_RULES(X)                                                     \
+    X(FIRST_IN_FIRST_OUT, "FIFO", job_id)                                     \
+    X(LONGEST_PROCESSING_TIME, "LPT", -jss->times[op])                        \
+    X(MOST_OPERATIONS_REMAINING, "MOR", -(jss->job_offsets[job_id + 1] - op)) \
+    X(MOST_WORK_REMAINING, "MWR", -jss->remaining_work[op])                   \
+    X(RANDOM, "RANDOM", 0) /* Chosen at pop time */                           \
+    X(SHORTEST_PROCESSING_TIME, "SPT", jss->times[op])                        \
+    X(SHORTEST_REMAINING_TIME, "SRT", jss->remaining_work[op])
+
+#define DISPATCH_RULE_ENUM(rule, name, priority) rule,
 typedef enum {
-    FIRST_IN_FIRST_OUT,
-    LONGEST_PROCESSING_TIME,
-    MOST_OPERATIONS_REMAINING,
-    MOST_WORK_REMAINING,
-    RANDOM,
-    SHORTEST_PROCESSING_TIME,
-    SHORTEST_REMAINING_TIME,
+    DISPATCH_RULES(DISPATCH_RULE_ENUM)
     DISPATCH_RULE_COUNT
 } dispatch_rule_t;
+#undef DISPATCH_RULE_ENUM
 
-typedef struct {
-    int job_ids[MAX_JOBS];
-    int op_ids[MAX_JOBS];
-    int machine_ids[MAX_JOBS];
-    int processing_times[MAX_JOBS];
-    int remaining_works[MAX_JOBS];
-    double priorities[MAX_JOBS];
-    int count;
-} operation_batch_t;
+// Not a dispatch rule: schedules built by the flow-shop engine
+#define NEH_CONSTRUCTION ((dispatch_rule_t)DISPATCH_RULE_COUNT)
+
+typedef struct jobshop_solution {
+    int num_jobs;
+    int num_machines;
+    int num_operations;
+    int makespan;
+    dispatch_rule_t rule_used; // Rule of the rollout the schedule descends from
+    const int* job_offsets; // Shared with the instance the solution belongs to
+    operation_schedule_t* schedule; // Indexed like jobshop_t operations
+} jobshop_solution_t;
 
+// Candidate schedules that are mostly discarded: start times only, since
+// machines and end times follow from the instance. A third of the memory
+// traffic of jobshop_solution_t; decoded once for the schedule that wins.
 typedef struct {
     int makespan;
     dispatch_rule_t rule_used;
-    // Keep the full solution separate to avoid copying
-} solution_summary_t;
+    int* start; // One entry per operation, indexed like jobshop_t operations
+} compact_solution_t;
+
+// Ready operations keyed by (priority, job_id), at most one per job
+typedef struct {
+    int* priorities;
+    int* job_ids;
+    int count;
+} ready_queue_t;
+
+static inline int jobshop_op_index(const jobshop_t* jss, int job_id, int op_idx) {
+    return jss->job_offsets[job_id] + op_idx;
+}
+
+static inline int jobshop_machine(const jobshop_t* jss, int job_id, int op_idx) {
+    return jss->machines[jss->job_offsets[job_id] + op_idx];
+}
+
+static inline int jobshop_time(const jobshop_t* jss, int job_id, int op_idx) {
+    return jss->times[jss->job_offsets[job_id] + op_idx];
+}
+
+static inline operation_schedule_t* solution_op(jobshop_solution_t* solution, int job_id, int op_idx) {
+    return &solution->schedule[solution->job_offsets[job_id] + op_idx];
+}
+
+static inline const operation_schedule_t* solution_op_const(const jobshop_solution_t* solution, int job_id, int op_idx) {
+    return &solution->schedule[solution->job_offsets[job_id] + op_idx];
+}
+
+int jobshop_init(jobshop_t* jss, arena_t* arena, int num_jobs, int num_machines);
+int jobshop_solution_init(jobshop_solution_t* solution, arena_t* arena, const jobshop_t* jss);
+void jobshop_solution_copy(jobshop_solution_t* dst, const jobshop_solution_t* src);
+int compact_solution_init(compact_solution_t* compact, arena_t* arena, const jobshop_t* jss);
+void jobshop_solution_decode(jobshop_solution_t* solution, const jobshop_t* jss, const compact_solution_t* compact);
 
 #endif
@@ -1,43 +1,338 @@
 #define _POSIX_C_SOURCE 200809L
+#include "affinity.h"
+#include "anytime.h"
+#include "batch.h"
+#include "bench.h"
+#include "bounds.h"
+#include "cache.h"
+#include "dispatch.h"
+#include "exact.h"
+#include "generate.h"
+#include "genetic.h"
+#include "instance.h"
+#include "online.h"
+#include "instrument.h"
 #include "jobshop.h"
 #include "parallel.h"
+#include "portfolio.h"
+#include "repair.h"
 #include "sequential.h"
+#include "serve.h"
 #include "utils.h"
 #include <getopt.h>
+#include <limits.h>
 #include <omp.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define DEFAULT_OUTPUT_DIR "./output"
+#define DEFAULT_SEED 1
+#define DEFAULT_RCL_SIZE 3
+#define DEFAULT_BENCH_WARMUP 3
+#define DEFAULT_BENCH_REPEATS 20
+
+// Long options without a short form
+enum {
+    OPT_SEED = 256,
+    OPT_RCL,
+    OPT_TABU,
+    OPT_TABU_PARALLEL,
+    OPT_GA,
+    OPT_POPULATION,
+    OPT_IG,
+    OPT_EXACT,
+    OPT_LIST,
+    OPT_CSV,
+    OPT_JSON,
+    OPT_BENCH,
+    OPT_WARMUP,
+    OPT_REPEATS,
+    OPT_BENCH_THREADS,
+    OPT_TRACE,
+    OPT_TO_BINARY,
+    OPT_STREAM,
+    OPT_RULE,
+    OPT_TIME_LIMIT,
+    OPT_PROGRESS,
+    OPT_PORTFOLIO,
+    OPT_CACHE,
+    OPT_PIN,
+    OPT_NUMA_REPLICAS,
+    OPT_SERVE,
+    OPT_SERVE_WORKERS,
+    OPT_REPAIR,
+    OPT_GENERATE,
+    OPT_TAILLARD_SEEDS,
+    OPT_FLOW_SHOP
+};
 
 static void print_usage(const char* program_name) {
-    printf("Usage: %s [OPTIONS]\n\n", program_name);
+    printf("Usage: %s [OPTIONS] [FILE...]\n\n", program_name);
     printf("Job Shop Scheduling Problem Solver\n\n");
     printf("Options:\n");
     printf("  -s, --sequential    Run sequential JSS solver\n");
     printf("  -p, --parallel      Run parallel JSS solver (requires OpenMP)\n");
-    printf("  -f, --file FILE     Input file containing JSS instance\n");
-    printf("  -o, --output [FILE] Output file for results (optional)\n");
+    printf("  -f, --file FILE     Input file containing JSS instance (repeatable, globs allowed)\n");
+    printf("  -o, --output [FILE] Output file for results, a directory in batch mode (optional)\n");
     printf("  -t, --threads N     Number of threads to use (default: auto)\n");
+    printf("  -r, --restarts N    Randomized greedy restarts after the rule pass (default: 0)\n");
+    printf("      --seed S        Seed for all random choices (default: %d)\n", DEFAULT_SEED);
+    printf("      --rcl K         Candidate list size for restarts (default: %d, max: %d)\n",
+        DEFAULT_RCL_SIZE, MAX_RCL_SIZE);
+    printf("      --tabu N        Tabu search iterations on the best schedule (default: 0)\n");
+    printf("      --tabu-parallel Evaluate tabu neighbourhoods across threads (with -p)\n");
+    printf("      --ga N          Island genetic algorithm generations, one island per thread (default: 0)\n");
+    printf("      --population P  Individuals per island (default: %d)\n", DEFAULT_GA_POPULATION);
+    printf("      --ig N          Iterated greedy steps per thread after NEH on flow shops (default: 0)\n");
+    printf("      --time-limit S  Stop improving after S seconds and keep the best schedule (default: none)\n");
+    printf("      --progress      Print each new best makespan with its time (time-to-incumbent)\n");
+    printf("      --portfolio K   Run K worker processes with their own seeds and keep the best (default: off)\n");
+    printf("      --cache DIR     Reuse results of identical runs and warm start improvement phases from DIR\n");
+    printf("      --pin POLICY    Pin threads to CPUs: compact (fill a NUMA node first) or scatter (default: off)\n");
+    printf("      --numa-replicas Give every NUMA node its own copy of the instance\n");
+    printf("      --repair FILE   Apply the changes in FILE to the solved schedule without re-solving\n");
+    printf("      --serve PATH    Solve instances sent to a Unix socket at PATH until SIGINT or SIGTERM\n");
+    printf("      --serve-workers W  Requests solved at once (default: threads with -s, 1 with -p)\n");
+    printf("      --exact         Prove optimality by branch and bound (small instances)\n");
+    printf("      --list FILE     Solve every path or glob listed in FILE, one per line\n");
+    printf("      --csv FILE      Write per-instance batch results as CSV\n");
+    printf("      --json FILE     Write per-instance batch results as JSON\n");
+    printf("      --bench         Benchmark every rule and solver configuration (JSON lines)\n");
+    printf("      --warmup N      Untimed runs per benchmark configuration (default: %d)\n", DEFAULT_BENCH_WARMUP);
+    printf("      --repeats N     Timed runs per benchmark configuration (default: %d)\n", DEFAULT_BENCH_REPEATS);
+    printf("      --bench-threads LIST  Parallel thread counts to benchmark, e.g. 1,2,4 or 1:8\n");
+    printf("                      (default: powers of two up to --threads)\n");
+    printf("      --trace FILE    Write per-rule and per-thread counters as JSON (INSTRUMENT=1 builds)\n");
+    printf("      --to-binary PATH  Convert the input to .jssb and exit (a directory for several inputs)\n");
+    printf("      --generate JxM  Write a Taillard instance with J jobs and M machines to -o and exit\n");
+    printf("                      (binary when the name ends in .jssb)\n");
+    printf("      --taillard-seeds T[,M]  Time and machine seeds for --generate (default: from --seed)\n");
+    printf("      --flow-shop     Generate a permutation flow shop instead of a job shop\n");
+    printf("      --stream        Schedule jobs as they arrive on stdin, or on -f FILE/FIFO\n");
+    printf("      --rule NAME     Dispatch rule for --stream: SPT, LPT, SRT, MWR, MOR, FIFO (default: MWR)\n");
     printf("  -h, --help          Show this help message\n\n");
+    printf("Several input files, --list, --csv or --json select batch mode: all\n");
+    printf("instances are solved in one process on a shared thread pool.\n\n");
     printf("Examples:\n");
     printf("  %s --sequential --file ft06.txt\n", program_name);
     printf("  %s -p -f jobshop_instance.txt\n", program_name);
     printf("  %s -p -f jobshop_instance.txt -o results.output\n", program_name);
+    printf("  %s -p -f jobshop_instance.txt -r 10000 --seed 7\n", program_name);
+    printf("  %s -s -f jobshop_instance.txt --tabu 20000\n", program_name);
+    printf("  %s -p -f ft06.jss --tabu 5000 --exact\n", program_name);
+    printf("  %s -p -f data/swv01.jss --ga 2000 --tabu 20000\n", program_name);
+    printf("  %s -p -t 16 -f data/ta41.jss -r 100000 --tabu 100000 --portfolio 4\n", program_name);
+    printf("  %s -p -f 'data/*.jss' --csv results.csv\n", program_name);
+    printf("  %s -p -f data/ta71.jss --bench --bench-threads 1,2,4,8 > bench.jsonl\n", program_name);
+    printf("  %s --generate 1000x50 -o ta_1000x50.jssb\n", program_name);
     printf("\nInput format:\n");
     printf("  Line 1: <num_jobs> <num_machines>\n");
     printf("  Next lines: <machine> <time> pairs for each job\n");
     printf("  Comments start with # and are ignored\n");
+    printf("  Files starting with JSSB are binary instances written by --to-binary\n");
+    printf("\nStream format (--stream):\n");
+    printf("  Line 1: <num_machines>\n");
+    printf("  Next lines: <release> followed by <machine> <time> pairs, one job per line\n");
+    printf("  Decisions are printed as <job> <operation> <machine> <start> <end>\n");
+}
+
+static int run_stream(const batch_files_t* files, const char* output_file, dispatch_rule_t rule) {
+    FILE* in = stdin;
+    FILE* out = stdout;
+    if (files->count > 1) {
+        fprintf(stderr, "Error: --stream reads a single input\n");
+        return EXIT_FAILURE;
+    }
+    if (files->count == 1 && !(in = fopen(files->paths[0], "r"))) {
+        fprintf(stderr, "Error: Cannot open file '%s'\n", files->paths[0]);
+        return EXIT_FAILURE;
+    }
+    if (output_file && !(out = fopen(output_file, "w"))) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", output_file);
+        if (in != stdin) {
+            fclose(in);
+        }
+        return EXIT_FAILURE;
+    }
+
+    int status = run_online(in, out, rule) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    return status;
+}
+
+// Seeds default to two distinct values in Taillard's range derived from --seed
+static int run_generate(const char* size, const char* seeds, uint64_t seed, bool flow_shop, const char* output_file) {
+    char* end;
+    long num_jobs = strtol(size, &end, 10);
+    long num_machines = 0;
+    if (end != size && (*end == 'x' || *end == 'X')) {
+        const char* machines = end + 1;
+        num_machines = strtol(machines, &end, 10);
+        num_machines = end != machines && *end == '\0' ? num_machines : 0;
+    }
+    if (num_jobs <= 0 || num_machines <= 0 || num_jobs > INT_MAX || num_machines > INT_MAX) {
+        fprintf(stderr, "Error: Invalid instance size '%s' (expected JOBSxMACHINES)\n", size);
+        return EXIT_FAILURE;
+    }
+    if (!output_file) {
+        fprintf(stderr, "Error: --generate needs an output file (-o)\n");
+        return EXIT_FAILURE;
+    }
+
+    long time_seed = (long)(1 + seed % (TAILLARD_MODULUS - 2));
+    long machine_seed = (long)(1 + (seed + 1) % (TAILLARD_MODULUS - 2));
+    if (seeds) {
+        time_seed = strtol(seeds, &end, 10);
+        machine_seed = *end == ',' ? strtol(end + 1, &end, 10) : machine_seed;
+        if (*end != '\0' || time_seed <= 0 || time_seed >= TAILLARD_MODULUS || machine_seed <= 0
+            || machine_seed >= TAILLARD_MODULUS) {
+            fprintf(stderr, "Error: Invalid Taillard seeds '%s' (T[,M] in [1, %d])\n", seeds, TAILLARD_MODULUS - 1);
+            return EXIT_FAILURE;
+        }
+    }
+
+    arena_t arena;
+    arena_init(&arena, 0);
+    jobshop_t jss;
+    size_t length = strlen(output_file);
+    int binary = length >= 5 && strcmp(output_file + length - 5, ".jssb") == 0;
+    int failed = generate_taillard(&jss, &arena, (int)num_jobs, (int)num_machines, (int32_t)time_seed,
+                     (int32_t)machine_seed, flow_shop)
+            < 0
+        || (binary ? write_jobshop_binary(output_file, &jss) : write_jobshop_text(output_file, &jss)) < 0;
+    arena_destroy(&arena);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int run_convert(const batch_files_t* files, const char* target) {
+    for (int i = 0; i < files->count; i++) {
+        char path[PATH_MAX];
+        if (files->count == 1) {
+            snprintf(path, sizeof(path), "%s", target);
+        } else {
+            const char* base = strrchr(files->paths[i], '/');
+            base = base ? base + 1 : files->paths[i];
+            snprintf(path, sizeof(path), "%s/%.*s.jssb", target, (int)strcspn(base, "."), base);
+        }
+
+        arena_t arena;
+        arena_init(&arena, 0);
+        jobshop_t jss;
+        int failed = read_jobshop_from_file(files->paths[i], &jss, &arena) < 0 || write_jobshop_binary(path, &jss) < 0;
+        arena_destroy(&arena);
+        if (failed) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+static int run_bench(const batch_files_t* files, const solver_config_t* config, bench_options_t* options) {
+    if (options->num_thread_counts == 0) {
+        for (int t = 1; t < config->num_threads && options->num_thread_counts < BENCH_MAX_THREAD_COUNTS - 1; t *= 2) {
+            options->thread_counts[options->num_thread_counts++] = t;
+        }
+        options->thread_counts[options->num_thread_counts++] = config->num_threads;
+    }
+
+    for (int i = 0; i < files->count; i++) {
+        arena_t arena;
+        arena_init(&arena, 0);
+        jobshop_t jss;
+        if (read_jobshop_from_file(files->paths[i], &jss, &arena) < 0
+            || run_benchmark(files->paths[i], &jss, config, options, stdout) < 0) {
+            fprintf(stderr, "Error: Benchmark failed for %s\n", files->paths[i]);
+            arena_destroy(&arena);
+            return EXIT_FAILURE;
+        }
+        arena_destroy(&arena);
+    }
+    return EXIT_SUCCESS;
+}
+
+static int run_batch(const batch_files_t* files, const solver_config_t* config, bool exact,
+    const char* output_dir, const char* csv_file, const char* json_file) {
+    batch_result_t* results = calloc((size_t)files->count, sizeof(batch_result_t));
+    if (!results) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    int failures = solve_batch(files, config, exact, output_dir, results);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    for (int i = 0; i < files->count; i++) {
+        printf("%s\t %d\t %.6fs\n", results[i].file, results[i].makespan, results[i].seconds);
+    }
+    printf("Instances:\t %d (%d failed)\n", files->count, failures);
+    printf("Solved in:\t %.6fs\n", get_time_diff(start_time, end_time));
+
+    int status = failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    if (csv_file && write_batch_csv(csv_file, results, files->count) < 0) {
+        status = EXIT_FAILURE;
+    }
+    if (json_file && write_batch_json(json_file, results, files->count) < 0) {
+        status = EXIT_FAILURE;
+    }
+
+    free(results);
+    return status;
 }
 
 int main(int argc, char** argv) {
     execution_mode_t mode = MODE_NONE;
     char* input_file = NULL;
     char* output_file = NULL;
+    char* csv_file = NULL;
+    char* json_file = NULL;
+    char* trace_file = NULL;
+    char* binary_target = NULL;
+    char* generate_size = NULL;
+    char* taillard_seeds = NULL;
+    bool flow_shop = false;
+    bool stream = false;
+    double time_limit = 0.0;
+    bool progress = false;
+    int portfolio = 0;
+    char* cache_dir = NULL;
+    pin_policy_t pin = PIN_NONE;
+    bool numa_replicas = false;
+    char* serve_path = NULL;
+    char* repair_file = NULL;
+    int serve_workers = 0;
+    dispatch_rule_t stream_rule = MOST_WORK_REMAINING;
+    bool batch = false;
+    bool bench = false;
+    bench_options_t bench_options = {
+        .warmup = DEFAULT_BENCH_WARMUP,
+        .repeats = DEFAULT_BENCH_REPEATS,
+        .num_thread_counts = 0,
+    };
+    batch_files_t files = { 0 };
     jobshop_t jss;
     jobshop_solution_t solution;
-    int num_threads = omp_get_max_threads();
+    bool exact = false;
+    exact_stats_t exact_stats = { 0 };
+    solver_config_t config = {
+        .num_threads = omp_get_max_threads(),
+        .seed = DEFAULT_SEED,
+        .restarts = 0,
+        .rcl_size = DEFAULT_RCL_SIZE,
+        .tabu_iterations = 0,
+        .tabu_parallel = 0,
+        .ga_generations = 0,
+        .ga_population = DEFAULT_GA_POPULATION,
+        .ig_iterations = 0,
+    };
 
     static struct option long_options[] = {
         { "sequential", no_argument, 0, 's' },
@@ -45,12 +340,44 @@ int main(int argc, char** argv) {
         { "file", required_argument, 0, 'f' },
         { "output", required_argument, 0, 'o' },
         { "threads", required_argument, 0, 't' },
+        { "restarts", required_argument, 0, 'r' },
+        { "seed", required_argument, 0, OPT_SEED },
+        { "rcl", required_argument, 0, OPT_RCL },
+        { "tabu", required_argument, 0, OPT_TABU },
+        { "tabu-parallel", no_argument, 0, OPT_TABU_PARALLEL },
+        { "ga", required_argument, 0, OPT_GA },
+        { "population", required_argument, 0, OPT_POPULATION },
+        { "ig", required_argument, 0, OPT_IG },
+        { "exact", no_argument, 0, OPT_EXACT },
+        { "list", required_argument, 0, OPT_LIST },
+        { "csv", required_argument, 0, OPT_CSV },
+        { "json", required_argument, 0, OPT_JSON },
+        { "bench", no_argument, 0, OPT_BENCH },
+        { "warmup", required_argument, 0, OPT_WARMUP },
+        { "repeats", required_argument, 0, OPT_REPEATS },
+        { "bench-threads", required_argument, 0, OPT_BENCH_THREADS },
+        { "trace", required_argument, 0, OPT_TRACE },
+        { "to-binary", required_argument, 0, OPT_TO_BINARY },
+        { "generate", required_argument, 0, OPT_GENERATE },
+        { "taillard-seeds", required_argument, 0, OPT_TAILLARD_SEEDS },
+        { "flow-shop", no_argument, 0, OPT_FLOW_SHOP },
+        { "stream", no_argument, 0, OPT_STREAM },
+        { "time-limit", required_argument, 0, OPT_TIME_LIMIT },
+        { "progress", no_argument, 0, OPT_PROGRESS },
+        { "rule", required_argument, 0, OPT_RULE },
+        { "portfolio", required_argument, 0, OPT_PORTFOLIO },
+        { "cache", required_argument, 0, OPT_CACHE },
+        { "pin", required_argument, 0, OPT_PIN },
+        { "numa-replicas", no_argument, 0, OPT_NUMA_REPLICAS },
+        { "repair", required_argument, 0, OPT_REPAIR },
+        { "serve", required_argument, 0, OPT_SERVE },
+        { "serve-workers", required_argument, 0, OPT_SERVE_WORKERS },
         { "help", no_argument, 0, 'h' },
         { 0, 0, 0, 0 }
     };
 
     int opt;
-    while ((opt = getopt_long(argc, argv, "spf:o:t:h", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "spf:o:t:r:h", long_options, NULL)) != -1) {
         switch (opt) {
         case 's':
             if (mode != MODE_NONE) {
@@ -72,20 +399,218 @@ int main(int argc, char** argv) {
             break;
         case 'f':
             input_file = optarg;
+            if (batch_add_pattern(&files, optarg) < 0) {
+                fprintf(stderr, "Error: Out of memory\n");
+                return EXIT_FAILURE;
+            }
             break;
         case 'o':
             output_file = optarg;
             break;
         case 't': {
             char* endptr;
-            num_threads = strtol(optarg, &endptr, 10);
-            if (*endptr != '\0' || num_threads <= 0) {
+            config.num_threads = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || config.num_threads <= 0) {
                 fprintf(stderr, "Error: Invalid number of threads '%s'\n",
                     optarg);
                 return EXIT_FAILURE;
             }
             break;
         }
+        case 'r': {
+            char* endptr;
+            long restarts = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || restarts < 0 || restarts > INT_MAX) {
+                fprintf(stderr, "Error: Invalid number of restarts '%s'\n",
+                    optarg);
+                return EXIT_FAILURE;
+            }
+            config.restarts = (int)restarts;
+            break;
+        }
+        case OPT_SEED: {
+            char* endptr;
+            config.seed = strtoull(optarg, &endptr, 10);
+            if (*endptr != '\0' || *optarg == '\0') {
+                fprintf(stderr, "Error: Invalid seed '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_RCL: {
+            char* endptr;
+            config.rcl_size = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || config.rcl_size <= 0 || config.rcl_size > MAX_RCL_SIZE) {
+                fprintf(stderr, "Error: Invalid candidate list size '%s'\n",
+                    optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_TABU: {
+            char* endptr;
+            config.tabu_iterations = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || config.tabu_iterations < 0) {
+                fprintf(stderr, "Error: Invalid number of tabu iterations '%s'\n",
+                    optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_TABU_PARALLEL:
+            config.tabu_parallel = 1;
+            break;
+        case OPT_GA: {
+            char* endptr;
+            config.ga_generations = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || config.ga_generations < 0) {
+                fprintf(stderr, "Error: Invalid number of generations '%s'\n",
+                    optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_POPULATION: {
+            char* endptr;
+            config.ga_population = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || config.ga_population < 2) {
+                fprintf(stderr, "Error: Invalid population size '%s' (minimum 2)\n",
+                    optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_IG: {
+            char* endptr;
+            config.ig_iterations = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || config.ig_iterations < 0) {
+                fprintf(stderr, "Error: Invalid number of iterated greedy steps '%s'\n",
+                    optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_EXACT:
+            exact = true;
+            break;
+        case OPT_LIST:
+            batch = true;
+            if (batch_add_list(&files, optarg) < 0) {
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_CSV:
+            batch = true;
+            csv_file = optarg;
+            break;
+        case OPT_JSON:
+            batch = true;
+            json_file = optarg;
+            break;
+        case OPT_BENCH:
+            bench = true;
+            break;
+        case OPT_WARMUP: {
+            char* endptr;
+            bench_options.warmup = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || bench_options.warmup < 0) {
+                fprintf(stderr, "Error: Invalid number of warmup runs '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_REPEATS: {
+            char* endptr;
+            bench_options.repeats = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || bench_options.repeats <= 0) {
+                fprintf(stderr, "Error: Invalid number of repeats '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_BENCH_THREADS:
+            if (parse_thread_list(optarg, &bench_options) < 0) {
+                fprintf(stderr, "Error: Invalid thread list '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_TRACE:
+            if (!instrument_enabled()) {
+                fprintf(stderr, "Error: --trace requires a build with INSTRUMENT=1\n");
+                return EXIT_FAILURE;
+            }
+            trace_file = optarg;
+            break;
+        case OPT_TO_BINARY:
+            binary_target = optarg;
+            break;
+        case OPT_GENERATE:
+            generate_size = optarg;
+            break;
+        case OPT_TAILLARD_SEEDS:
+            taillard_seeds = optarg;
+            break;
+        case OPT_FLOW_SHOP:
+            flow_shop = true;
+            break;
+        case OPT_STREAM:
+            stream = true;
+            break;
+        case OPT_TIME_LIMIT: {
+            char* endptr;
+            time_limit = strtod(optarg, &endptr);
+            if (*endptr != '\0' || !(time_limit > 0.0)) {
+                fprintf(stderr, "Error: Invalid time limit '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_PROGRESS:
+            progress = true;
+            break;
+        case OPT_PORTFOLIO: {
+            char* endptr;
+            portfolio = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || portfolio < 1 || portfolio > MAX_PORTFOLIO_WORKERS) {
+                fprintf(stderr, "Error: Invalid number of portfolio workers '%s' (1-%d)\n", optarg,
+                    MAX_PORTFOLIO_WORKERS);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_CACHE:
+            cache_dir = optarg;
+            break;
+        case OPT_PIN:
+            if (affinity_policy_from_name(optarg, &pin) < 0) {
+                fprintf(stderr, "Error: Unknown pin policy '%s' (compact or scatter)\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_NUMA_REPLICAS:
+            numa_replicas = true;
+            break;
+        case OPT_REPAIR:
+            repair_file = optarg;
+            break;
+        case OPT_SERVE:
+            serve_path = optarg;
+            break;
+        case OPT_SERVE_WORKERS: {
+            char* endptr;
+            serve_workers = strtol(optarg, &endptr, 10);
+            if (*endptr != '\0' || serve_workers < 1 || serve_workers > MAX_SERVE_WORKERS) {
+                fprintf(stderr, "Error: Invalid number of serve workers '%s' (1-%d)\n", optarg, MAX_SERVE_WORKERS);
+                return EXIT_FAILURE;
+            }
+            break;
+        }
+        case OPT_RULE:
+            if (dispatch_rule_from_name(optarg, &stream_rule) < 0 || stream_rule == RANDOM) {
+                fprintf(stderr, "Error: Unknown dispatch rule '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
         case 'h':
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -95,7 +620,11 @@ int main(int argc, char** argv) {
         }
     }
 
-    if (mode == MODE_NONE) {
+    if (generate_size) {
+        return run_generate(generate_size, taillard_seeds, config.seed, flow_shop, output_file);
+    }
+
+    if (mode == MODE_NONE && !bench && !binary_target && !stream) {
         fprintf(stderr,
             "Error: You must specify either sequential (-s) or "
             "parallel (-p) mode\n");
@@ -103,51 +632,238 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
-    if (!input_file) {
+    for (int i = optind; i < argc; i++) {
+        if (batch_add_pattern(&files, argv[i]) < 0) {
+            fprintf(stderr, "Error: Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (stream) {
+        int status = run_stream(&files, output_file, stream_rule);
+        batch_files_free(&files);
+        return status;
+    }
+
+    if (serve_path) {
+        if (files.count > 0 || portfolio > 0 || cache_dir || pin != PIN_NONE || numa_replicas || exact || repair_file) {
+            fprintf(stderr,
+                "Error: --serve reads instances from its socket and cannot be combined with -f, --list, "
+                "--portfolio, --cache, --pin, --numa-replicas, --exact or --repair\n");
+            batch_files_free(&files);
+            return EXIT_FAILURE;
+        }
+        serve_options_t options = {
+            .socket_path = serve_path,
+            .mode = mode,
+            .num_workers = serve_workers > 0 ? serve_workers : mode == MODE_SEQUENTIAL ? config.num_threads : 1,
+            .time_limit = time_limit,
+        };
+        return run_server(&options, &config) < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (files.count == 0) {
         fprintf(stderr,
             "Error: You must specify an input file with -f/--file\n");
         print_usage(argv[0]);
         return EXIT_FAILURE;
     }
 
-    if (read_jobshop_from_file(input_file, &jss) < 0) {
+    // Pinned before any solver forms a team, so the thread pool keeps its
+    // placement. Forked portfolio workers would inherit one CPU's mask.
+    if (pin != PIN_NONE) {
+        if (portfolio > 0) {
+            fprintf(stderr, "Error: --pin cannot be combined with --portfolio\n");
+            batch_files_free(&files);
+            return EXIT_FAILURE;
+        }
+        if (affinity_pin_threads(pin, config.num_threads) < 0) {
+            batch_files_free(&files);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (binary_target) {
+        int status = run_convert(&files, binary_target);
+        batch_files_free(&files);
+        return status;
+    }
+
+    if (bench) {
+        int status = run_bench(&files, &config, &bench_options);
+        if (status == EXIT_SUCCESS && trace_file && instrument_write_trace(trace_file) < 0) {
+            status = EXIT_FAILURE;
+        }
+        batch_files_free(&files);
+        return status;
+    }
+
+    // The budget starts before any instance is read; Ctrl-C ends it early
+    anytime_t anytime;
+    anytime_init(&anytime, time_limit, progress ? stdout : NULL);
+    anytime_install_interrupt();
+    config.anytime = &anytime;
+
+    if (batch || files.count > 1) {
+        if (portfolio > 0 || cache_dir || numa_replicas || repair_file) {
+            fprintf(stderr, "Error: --portfolio, --cache, --numa-replicas and --repair solve a single instance\n");
+            batch_files_free(&files);
+            return EXIT_FAILURE;
+        }
+        if (mode == MODE_SEQUENTIAL) {
+            config.num_threads = 1;
+        }
+        int status = run_batch(&files, &config, exact, output_file, csv_file, json_file);
+        if (status == EXIT_SUCCESS && trace_file && instrument_write_trace(trace_file) < 0) {
+            status = EXIT_FAILURE;
+        }
+        batch_files_free(&files);
+        return status;
+    }
+    input_file = files.paths[0];
+
+    arena_t arena;
+    arena_init(&arena, 0);
+
+    if (read_jobshop_from_file(input_file, &jss, &arena) < 0
+        || jobshop_solution_init(&solution, &arena, &jss) < 0) {
+        arena_destroy(&arena);
         return EXIT_FAILURE;
     }
 
     // print_jobshop_instance(&jss);
 
-    solution.num_jobs = jss.num_jobs;
-    solution.num_machines = jss.num_machines;
-    solution.makespan = 0;
+    if (numa_replicas && affinity_replicate_instance(&jss, config.num_threads) < 0) {
+        arena_destroy(&arena);
+        return EXIT_FAILURE;
+    }
 
     struct timespec start_time, end_time;
     clock_gettime(CLOCK_MONOTONIC, &start_time);
 
-    switch (mode) {
-    case MODE_SEQUENTIAL:
-        solve_sequential(&jss, &solution);
-        break;
-    case MODE_PARALLEL:
-        solve_parallel(&jss, &solution, num_threads);
-        break;
-    default:
-        fprintf(stderr, "Error: Invalid execution mode\n");
+    // Any phase that reaches the bound has found an optimum and stops the rest
+    lower_bound_t bound;
+    if (compute_lower_bound(&jss, mode == MODE_SEQUENTIAL ? 1 : config.num_threads, &bound) < 0) {
+        fprintf(stderr, "Error: Failed to compute lower bound (out of memory)\n");
+        arena_destroy(&arena);
+        return EXIT_FAILURE;
+    }
+    anytime_set_lower_bound(&anytime, bound.value);
+
+    // A hit skips solving; otherwise the best cached schedule of any
+    // configuration replaces the rule pass of the improvement phases
+    solution_cache_t cache;
+    uint64_t config_hash = 0;
+    jobshop_solution_t cached_best;
+    int cache_hit = 0;
+    int have_best = 0;
+    if (cache_dir) {
+        config_hash = cache_config_hash(&config, mode, exact, portfolio);
+        if (cache_open(&cache, cache_dir, &jss) < 0 || jobshop_solution_init(&cached_best, &arena, &jss) < 0) {
+            arena_destroy(&arena);
+            return EXIT_FAILURE;
+        }
+        cache_hit = cache_load(&cache, &jss, config_hash, &solution);
+        have_best = !cache_hit && cache_load(&cache, &jss, CACHE_BEST, &cached_best);
+        if (have_best
+            && (config.restarts > 0 || config.ga_generations > 0 || config.tabu_iterations > 0 || exact
+                || (jss.flow_shop && config.ig_iterations > 0))) {
+            config.warm_start = &cached_best;
+        }
+    }
+
+    int result = -1;
+    if (cache_hit) {
+        result = solution.makespan;
+        anytime_publish(&anytime, result, "cache");
+        exact_stats.proven_optimal = 1; // Exact runs are only stored when they finish
+    } else if (portfolio > 0) {
+        result = solve_portfolio(&jss, &solution, &config, mode, portfolio);
+    } else if (mode == MODE_SEQUENTIAL) {
+        result = solve_sequential(&jss, &solution, &config);
+    } else {
+        result = solve_parallel(&jss, &solution, &config);
+    }
+
+    // The heuristic result seeds the branch and bound upper bound
+    if (result >= 0 && exact && !cache_hit) {
+        solver_config_t exact_config = config;
+        if (mode == MODE_SEQUENTIAL) {
+            exact_config.num_threads = 1;
+        }
+        result = solve_exact(&jss, &solution, &exact_config, &exact_stats);
+    }
+
+    if (result < 0) {
+        fprintf(stderr, "Error: Failed to solve instance (out of memory)\n");
+        arena_destroy(&arena);
         return EXIT_FAILURE;
     }
 
+    // Results cut short by a deadline or Ctrl-C are not what the configuration produces
+    if (cache_dir && !cache_hit) {
+        if (!anytime_cancelled(&anytime) || anytime_optimal(&anytime)) {
+            cache_store(&cache, &jss, config_hash, &solution);
+        }
+        if (!have_best || solution.makespan < cached_best.makespan) {
+            cache_store(&cache, &jss, CACHE_BEST, &solution);
+        }
+    }
+
     clock_gettime(CLOCK_MONOTONIC, &end_time);
     double elapsed = get_time_diff(start_time, end_time);
     printf("Solved in:\t %.6fs\n", elapsed);
     printf("Makespan:\t %d\n", solution.makespan);
+    printf("Lower bound:\t %d\n", bound.value);
+    printf("Gap:\t\t %.2f%%\n", lower_bound_gap(solution.makespan, bound.value));
+    if (cache_dir) {
+        printf("Cache:\t\t %s\n", cache_hit ? "hit" : config.warm_start ? "warm start" : "miss");
+    }
+    if (exact) {
+        printf("Nodes:\t\t %ld\n", exact_stats.nodes);
+        printf("Optimal:\t %s\n", exact_stats.proven_optimal ? "proven" : "not proven");
+    }
+    if (anytime_optimal(&anytime)) {
+        printf("Stopped:\t lower bound reached (optimal)\n");
+    } else if (anytime_cancelled(&anytime)) {
+        printf("Stopped:\t %s\n", time_limit > 0.0 && anytime_elapsed(&anytime) >= time_limit ? "time limit" : "interrupted");
+    }
+
+    // Changes are applied to the final schedule; the repaired one is written instead
+    if (repair_file) {
+        repair_state_t repair;
+        if (repair_init(&repair, &jss, &solution) < 0) {
+            fprintf(stderr, "Error: Out of memory\n");
+            arena_destroy(&arena);
+            return EXIT_FAILURE;
+        }
+        int failed = repair_run_script(&repair, repair_file, stdout) < 0
+            || repair_export(&repair, &jss, &solution, &arena) < 0;
+        repair_destroy(&repair);
+        if (failed) {
+            arena_destroy(&arena);
+            return EXIT_FAILURE;
+        }
+        printf("Repaired:\t %d (%d jobs)\n", solution.makespan, jss.num_jobs);
+    }
 
     // print_jobshop_solution(&solution);
     if (output_file) {
         if (write_jobshop_solution_to_file(output_file, &solution) < 0) {
             fprintf(stderr, "Error: Failed to write solution to file %s\n",
                 output_file);
+            arena_destroy(&arena);
             return EXIT_FAILURE;
         }
     }
 
+    if (trace_file && instrument_write_trace(trace_file) < 0) {
+        arena_destroy(&arena);
+        return EXIT_FAILURE;
+    }
+
+    affinity_release_replicas();
+    arena_destroy(&arena);
+    batch_files_free(&files);
     return EXIT_SUCCESS;
 }
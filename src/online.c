@@ -0,0 +1,305 @@
+#define _POSIX_C_SOURCE 200809L
+#include "online.h"
+#include "dispatch.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static volatile sig_atomic_t online_stop = 0;
+
+static void online_handle_signal(int signum) {
+    (void)signum;
+    online_stop = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void latency_record(latency_histogram_t* histogram, uint64_t ns) {
+    int bucket = ns > 1 ? 63 - __builtin_clzll(ns) : 0;
+    histogram->buckets[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+    histogram->count++;
+    histogram->total_ns += ns;
+    if (ns > histogram->max_ns) {
+        histogram->max_ns = ns;
+    }
+}
+
+// Upper edge of the bucket holding the given percentile, capped by the maximum
+static uint64_t latency_percentile(const latency_histogram_t* histogram, double percent) {
+    uint64_t rank = (uint64_t)(percent / 100.0 * (double)histogram->count + 0.5);
+    rank = rank > 0 ? rank : 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += histogram->buckets[b];
+        if (seen >= rank) {
+            uint64_t edge = (2ULL << b) - 1;
+            return edge < histogram->max_ns ? edge : histogram->max_ns;
+        }
+    }
+    return histogram->max_ns;
+}
+
+void latency_report(const latency_histogram_t* histogram, const char* label, FILE* out) {
+    if (histogram->count == 0) {
+        fprintf(out, "%s:\t no arrivals\n", label);
+        return;
+    }
+    fprintf(out, "%s (us):\t mean %.2f  p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n", label,
+        histogram->total_ns / 1e3 / histogram->count, latency_percentile(histogram, 50.0) / 1e3,
+        latency_percentile(histogram, 90.0) / 1e3, latency_percentile(histogram, 99.0) / 1e3,
+        latency_percentile(histogram, 99.9) / 1e3, histogram->max_ns / 1e3);
+    fprintf(out, "Histogram (ns):\n");
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        if (histogram->buckets[b] > 0) {
+            fprintf(out, "  %12llu - %-12llu %llu\n", b > 0 ? 1ULL << b : 0ULL, (2ULL << b) - 1,
+                (unsigned long long)histogram->buckets[b]);
+        }
+    }
+}
+
+// Same orderings as dispatch_priority, from the job's live state
+static int online_priority(const online_job_t* job, dispatch_rule_t rule) {
+    int time = job->times[job->next_operation];
+    switch (rule) {
+    case SHORTEST_PROCESSING_TIME:
+        return time;
+    case LONGEST_PROCESSING_TIME:
+        return -time;
+    case SHORTEST_REMAINING_TIME:
+        return job->remaining_work;
+    case MOST_WORK_REMAINING:
+        return -job->remaining_work;
+    case MOST_OPERATIONS_REMAINING:
+        return -(job->num_operations - job->next_operation);
+    default:
+        return 0; // FIFO: ties fall through to arrival order
+    }
+}
+
+// Non-delay dispatching up to (but excluding) time `until`: repeatedly take the
+// operation that can start earliest, the rule deciding between equal starts and
+// arrival order between equal priorities. Later arrivals are released at or
+// after `until`, so nothing committed here can be invalidated by them.
+static void online_advance(online_state_t* state, int until, FILE* out) {
+    while (state->num_active > 0) {
+        int best = -1;
+        int best_start = INT_MAX;
+        int best_priority = INT_MAX;
+        for (int i = 0; i < state->num_active; i++) {
+            const online_job_t* job = &state->jobs[i];
+            int start = max(job->ready_time, state->machine_completion_time[job->machines[job->next_operation]]);
+            if (start > best_start) {
+                continue;
+            }
+            int priority = online_priority(job, state->rule);
+            if (start < best_start || priority < best_priority
+                || (priority == best_priority && job->id < state->jobs[best].id)) {
+                best = i;
+                best_start = start;
+                best_priority = priority;
+            }
+        }
+        if (best_start >= until) {
+            return;
+        }
+
+        online_job_t* job = &state->jobs[best];
+        int op = job->next_operation++;
+        int machine = job->machines[op];
+        int end = best_start + job->times[op];
+        state->machine_completion_time[machine] = end;
+        job->ready_time = end;
+        job->remaining_work -= job->times[op];
+        state->makespan = max(state->makespan, end);
+        state->operations++;
+        fprintf(out, "%ld\t%d\t%d\t%d\t%d\n", job->id, op, machine, best_start, end);
+
+        // Finished jobs swap to the end of the active range, keeping their buffers
+        if (job->next_operation == job->num_operations) {
+            online_job_t finished = *job;
+            *job = state->jobs[--state->num_active];
+            state->jobs[state->num_active] = finished;
+        }
+    }
+}
+
+static online_job_t* online_claim_slot(online_state_t* state) {
+    if (state->num_active == state->num_slots) {
+        int slots = state->num_slots > 0 ? 2 * state->num_slots : 64;
+        online_job_t* jobs = realloc(state->jobs, (size_t)slots * sizeof(online_job_t));
+        if (!jobs) {
+            return NULL;
+        }
+        memset(jobs + state->num_slots, 0, (size_t)(slots - state->num_slots) * sizeof(online_job_t));
+        state->jobs = jobs;
+        state->num_slots = slots;
+    }
+    return &state->jobs[state->num_active];
+}
+
+// "<release> <machine> <time> ..." into the next free slot; -1 on malformed input
+static int online_parse_job(online_state_t* state, char* line, online_job_t* job, int* release) {
+    char* pos = line;
+    char* end;
+    long value = strtol(pos, &end, 10);
+    if (end == pos || value < 0 || value > INT_MAX) {
+        return -1;
+    }
+    *release = (int)value;
+    pos = end;
+
+    job->num_operations = 0;
+    job->remaining_work = 0;
+    for (;;) {
+        long machine = strtol(pos, &end, 10);
+        if (end == pos) {
+            break;
+        }
+        pos = end;
+        long time = strtol(pos, &end, 10);
+        if (end == pos || machine < 0 || machine >= state->num_machines || time < 0 || time > INT_MAX - job->remaining_work) {
+            return -1;
+        }
+        pos = end;
+
+        if (job->num_operations == job->capacity) {
+            int capacity = job->capacity > 0 ? 2 * job->capacity : 16;
+            int* machines = realloc(job->machines, (size_t)capacity * sizeof(int));
+            if (machines) {
+                job->machines = machines;
+            }
+            int* times = realloc(job->times, (size_t)capacity * sizeof(int));
+            if (times) {
+                job->times = times;
+            }
+            if (!machines || !times) {
+                return -1;
+            }
+            job->capacity = capacity;
+        }
+        job->machines[job->num_operations] = (int)machine;
+        job->times[job->num_operations] = (int)time;
+        job->num_operations++;
+        job->remaining_work += (int)time;
+    }
+    while (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n') {
+        pos++;
+    }
+    return job->num_operations > 0 && (*pos == '\0' || *pos == '#') ? 0 : -1;
+}
+
+static int is_blank_line(const char* line) {
+    line += strspn(line, " \t\r\n");
+    return *line == '\0' || *line == '#';
+}
+
+// Reads "<num_machines>" and then one job per line from `in`, writing
+// "job operation machine start end" decisions to `out` as soon as they are
+// final. Latency is measured per arrival from the line being read to its
+// decisions being flushed, and reported on stderr at end of input or SIGINT.
+int run_online(FILE* in, FILE* out, dispatch_rule_t rule) {
+    online_state_t state = { 0 };
+    state.rule = rule;
+
+    char* line = NULL;
+    size_t line_capacity = 0;
+    long line_number = 0;
+    while (getline(&line, &line_capacity, in) >= 0) {
+        line_number++;
+        if (is_blank_line(line)) {
+            continue;
+        }
+        char* end;
+        long machines = strtol(line, &end, 10);
+        if (end == line || machines <= 0 || machines > INT_MAX || !is_blank_line(end)) {
+            fprintf(stderr, "Error: Expected '<num_machines>' on line %ld\n", line_number);
+            free(line);
+            return -1;
+        }
+        state.num_machines = (int)machines;
+        break;
+    }
+    if (state.num_machines == 0) {
+        fprintf(stderr, "Error: Missing '<num_machines>' header\n");
+        free(line);
+        return -1;
+    }
+    state.machine_completion_time = calloc((size_t)state.num_machines, sizeof(int));
+    if (!state.machine_completion_time) {
+        fprintf(stderr, "Error: Out of memory\n");
+        free(line);
+        return -1;
+    }
+
+    // No SA_RESTART, so a pending read returns on Ctrl-C and the report still prints
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = online_handle_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    while (!online_stop) {
+        if (getline(&line, &line_capacity, in) < 0) {
+            break;
+        }
+        uint64_t arrival = now_ns();
+        line_number++;
+        if (is_blank_line(line)) {
+            continue;
+        }
+
+        online_job_t* job = online_claim_slot(&state);
+        int release;
+        if (!job || online_parse_job(&state, line, job, &release) < 0) {
+            fprintf(stderr, "Error: Skipping malformed job on line %ld\n", line_number);
+            continue;
+        }
+
+        // Arrivals are expected in release order; a late one is released now
+        release = max(release, state.horizon);
+        int slot = state.num_active;
+        online_advance(&state, release, out);
+        state.horizon = release;
+
+        // Jobs finished meanwhile shrank the active range; move the new one to its end
+        if (slot != state.num_active) {
+            online_job_t parsed = state.jobs[slot];
+            state.jobs[slot] = state.jobs[state.num_active];
+            state.jobs[state.num_active] = parsed;
+        }
+        job = &state.jobs[state.num_active];
+        job->id = state.next_job_id++;
+        job->next_operation = 0;
+        job->ready_time = release;
+        state.num_active++;
+
+        fflush(out);
+        latency_record(&state.latency, now_ns() - arrival);
+    }
+
+    online_advance(&state, INT_MAX, out);
+    fflush(out);
+
+    fprintf(stderr, "Jobs:\t\t %ld\n", state.next_job_id);
+    fprintf(stderr, "Operations:\t %ld\n", state.operations);
+    fprintf(stderr, "Makespan:\t %d\n", state.makespan);
+    latency_report(&state.latency, "Latency", stderr);
+
+    for (int i = 0; i < state.num_slots; i++) {
+        free(state.jobs[i].machines);
+        free(state.jobs[i].times);
+    }
+    free(state.jobs);
+    free(state.machine_completion_time);
+    free(line);
+    return 0;
+}
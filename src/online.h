@@ -0,0 +1,50 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include "jobshop.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define LATENCY_BUCKETS 48 // Power-of-two nanosecond buckets, up to ~39 hours
+
+// Bucket b counts latencies in [2^b, 2^(b+1)) ns, bucket 0 also holds 0 ns
+typedef struct {
+    uint64_t buckets[LATENCY_BUCKETS];
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} latency_histogram_t;
+
+// A released job that still has operations to schedule
+typedef struct {
+    long id; // Arrival order
+    int* machines;
+    int* times;
+    int capacity;
+    int num_operations;
+    int next_operation;
+    int ready_time; // Release, then completion of the last scheduled operation
+    int remaining_work;
+} online_job_t;
+
+// Live dispatch state. Only unfinished jobs are kept, so the cost of a
+// decision depends on the work in progress, not on how many jobs have passed.
+typedef struct {
+    int num_machines;
+    int* machine_completion_time;
+    online_job_t* jobs; // Active jobs first, reusable buffers after them
+    int num_active;
+    int num_slots;
+    dispatch_rule_t rule;
+    int horizon; // Latest release seen; decisions before it are final
+    long next_job_id;
+    long operations;
+    int makespan;
+    latency_histogram_t latency;
+} online_state_t;
+
+void latency_record(latency_histogram_t* histogram, uint64_t ns);
+void latency_report(const latency_histogram_t* histogram, const char* label, FILE* out);
+int run_online(FILE* in, FILE* out, dispatch_rule_t rule);
+
+#endif
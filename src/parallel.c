@@ -1,156 +1,168 @@
+#define _POSIX_C_SOURCE 200809L
 #include "parallel.h"
+#include "affinity.h"
+#include "anytime.h"
+#include "dispatch.h"
+#include "flowshop.h"
+#include "genetic.h"
+#include "grasp.h"
+#include "instrument.h"
 #include "jobshop.h"
+#include "tabu.h"
 #include "utils.h"
 #include <limits.h>
 #include <omp.h>
 #include <stdlib.h>
 #include <string.h>
 
-static int solve_with_dispatch_rule_parallel(const jobshop_t* jss, jobshop_solution_t* solution, dispatch_rule_t rule) {
-    int machine_completion_time[MAX_MACHINES] = { 0 };
-    int job_next_operation[MAX_JOBS] = { 0 };
-    int operations_completed = 0;
-    int total_operations = jss->num_jobs * jss->num_machines;
-
-    solution->num_jobs = jss->num_jobs;
-    solution->num_machines = jss->num_machines;
-
-    while (operations_completed < total_operations) {
-        // Find all ready operations using struct-of-arrays
-        operation_batch_t ready_ops = { .count = 0 };
-
-        for (int job_id = 0; job_id < jss->num_jobs; job_id++) {
-            int op_idx = job_next_operation[job_id];
-            if (op_idx < jss->num_machines) {
-                int idx = ready_ops.count;
-                ready_ops.job_ids[idx] = job_id;
-                ready_ops.op_ids[idx] = op_idx;
-                ready_ops.machine_ids[idx] = jss->machines[job_id][op_idx];
-                ready_ops.processing_times[idx] = jss->times[job_id][op_idx];
-                ready_ops.remaining_works[idx] = calculate_remaining_work(jss, job_id, op_idx);
-
-                // Calculate priority based on dispatch rule
-                switch (rule) {
-                case SHORTEST_PROCESSING_TIME:
-                    ready_ops.priorities[idx] = ready_ops.processing_times[idx];
-                    break;
-                case LONGEST_PROCESSING_TIME:
-                    ready_ops.priorities[idx] = -ready_ops.processing_times[idx];
-                    break;
-                case SHORTEST_REMAINING_TIME:
-                    ready_ops.priorities[idx] = ready_ops.remaining_works[idx];
-                    break;
-                case MOST_WORK_REMAINING:
-                    ready_ops.priorities[idx] = -ready_ops.remaining_works[idx];
-                    break;
-                case FIRST_IN_FIRST_OUT:
-                    ready_ops.priorities[idx] = job_id;
-                    break;
-                case MOST_OPERATIONS_REMAINING:
-                    ready_ops.priorities[idx] = -(jss->num_machines - op_idx);
-                    break;
-                case RANDOM:
-                    ready_ops.priorities[idx] = rand() % 1000;
-                    break;
-                default:
-                    ready_ops.priorities[idx] = job_id; // FIFO as fallback
-                }
-                ready_ops.count++;
-            }
-        }
-
-        // Find operation with best priority (minimum value)
-        int best_idx = 0;
-        for (int i = 1; i < ready_ops.count; i++) {
-            if (ready_ops.priorities[i] < ready_ops.priorities[best_idx]) {
-                best_idx = i;
-            }
-        }
-
-        // Schedule the highest priority operation
-        int job_id = ready_ops.job_ids[best_idx];
-        int op_idx = ready_ops.op_ids[best_idx];
-        int machine_id = ready_ops.machine_ids[best_idx];
-        int processing_time = ready_ops.processing_times[best_idx];
-
-        // Calculate start time
-        int job_completion_time = 0;
-        if (op_idx > 0) {
-            job_completion_time = solution->schedule[job_id][op_idx - 1].end_time;
-        }
-
-        int start_time = max(machine_completion_time[machine_id], job_completion_time);
-
-        // Store in solution
-        solution->schedule[job_id][op_idx].machine_id = machine_id;
-        solution->schedule[job_id][op_idx].start_time = start_time;
-        solution->schedule[job_id][op_idx].end_time = start_time + processing_time;
-
-        // Update completion times
-        machine_completion_time[machine_id] = start_time + processing_time;
-        job_next_operation[job_id]++;
-        operations_completed++;
-    }
-
-    // Calculate makespan
-    int makespan = 0;
-    for (int job_id = 0; job_id < jss->num_jobs; job_id++) {
-        int job_end = solution->schedule[job_id][jss->num_machines - 1].end_time;
-        if (job_end > makespan) {
-            makespan = job_end;
-        }
+// Best of one group, alone on its cache line: groups finish at different
+// times and must not invalidate each other's slot
+typedef struct {
+    compact_solution_t* best;
+    int rule;
+    char padding[CACHE_LINE_SIZE - sizeof(compact_solution_t*) - sizeof(int)];
+} multi_pass_slot_t;
+
+// Rules run side by side only when the measured fork/join cost pays off.
+// Threads the rules leave idle pair up on wide instances: in each pair one
+// thread selects the dispatch order and the other decodes it, so a single
+// rollout uses two cores with the schedule unchanged.
+static int multi_pass_pipelined(const jobshop_t* jss, int threads, int num_threads, double rollout_seconds) {
+    if (2 * threads > num_threads || 2 * threads > omp_get_num_procs()
+        || jss->num_operations < 2 * DISPATCH_PIPELINE_BLOCK) {
+        return 0;
     }
-
-    solution->makespan = makespan;
-    return makespan;
+    // At best a pair halves the rollout; the larger team must cost less than that
+    return rollout_seconds / 2 > fork_join_seconds(2 * threads) + fork_join_seconds(2);
 }
 
-int solve_multi_pass_parallel(const jobshop_t* jss, jobshop_solution_t* solution, int num_threads) {
+int solve_multi_pass_parallel(const jobshop_t* jss, jobshop_solution_t* solution, int num_threads, uint64_t seed) {
     omp_set_num_threads(num_threads);
 
-    // Use solution summaries to track results
-    solution_summary_t results[DISPATCH_RULE_COUNT];
-    jobshop_solution_t temp_solutions[DISPATCH_RULE_COUNT];
-
-    // Try different dispatch rules
-    dispatch_rule_t rules[] = {
-        SHORTEST_PROCESSING_TIME,
-        LONGEST_PROCESSING_TIME,
-        SHORTEST_REMAINING_TIME,
-        MOST_WORK_REMAINING,
-        FIRST_IN_FIRST_OUT,
-        MOST_OPERATIONS_REMAINING,
-        RANDOM
-    };
-
-    int num_rules = sizeof(rules) / sizeof(rules[0]);
+    const dispatch_rule_t* rules = multi_pass_rules;
+    int num_rules = DISPATCH_RULE_COUNT;
+    double rollout_seconds = dispatch_rollout_seconds(jss);
+    int threads = get_optimal_thread_count(num_rules, rollout_seconds, num_threads);
+    int width = multi_pass_pipelined(jss, threads, num_threads, rollout_seconds) ? 2 : 1;
+
+    // Each group keeps only its local best; the winner is picked by pointer
+    multi_pass_slot_t* slots = cache_aligned_calloc((size_t)threads, sizeof(multi_pass_slot_t));
+    dispatch_pipeline_t* pipelines = width > 1 ? cache_aligned_calloc((size_t)threads, sizeof(dispatch_pipeline_t)) : NULL;
+    if (!slots || (width > 1 && !pipelines)) {
+        free(slots);
+        free(pipelines);
+        return -1;
+    }
 
-#pragma omp parallel
+    int failed = 0;
+#pragma omp parallel num_threads(threads * width)
     {
+        // A team smaller than asked for still covers every rule
         int thread_id = omp_get_thread_num();
-        srand(time(NULL) + thread_id);
-#pragma omp for schedule(dynamic)
-        for (int i = 0; i < num_rules; i++) {
-            int makespan = solve_with_dispatch_rule_parallel(jss, &temp_solutions[i], rules[i]);
+        int group_width = omp_get_num_threads() >= 2 ? width : 1;
+        int groups = omp_get_num_threads() / group_width;
+        int group = thread_id / group_width;
+        int selects = group_width > 1 && thread_id % 2 == 0;
+
+        // Each thread owns its dispatch state and two compact buffers, first
+        // touched here, and reads the instance from its node's replica
+        const jobshop_t* local = affinity_local_instance(jss);
+        arena_t thread_arena;
+        arena_init(&thread_arena, 0);
+        dispatch_scratch_t scratch;
+        compact_solution_t candidates[2];
+        compact_solution_t* best = NULL;
+        int best_rule = INT_MAX;
+        int local_failed = dispatch_scratch_init(&scratch, &thread_arena, local) < 0
+            || compact_solution_init(&candidates[0], &thread_arena, local) < 0
+            || compact_solution_init(&candidates[1], &thread_arena, local) < 0
+            || (selects && group < groups && dispatch_pipeline_init(&pipelines[group], &thread_arena, local) < 0);
+        if (local_failed) {
+#pragma omp atomic write
+            failed = 1;
+        }
+        // A pair must not wait on a partner that failed to start
+#pragma omp barrier
+        INSTR_REGION_BEGIN(region);
+
+        for (int i = group; i < num_rules && group < groups && !failed; i += groups) {
+            INSTR_BUSY_BEGIN(region);
+            // Stream per rule, so results do not depend on the thread count
+            rng_seed(&scratch.rng, seed, i);
+            if (selects) {
+                dispatch_pipeline_select(local, &pipelines[group], rules[i], &scratch);
+                INSTR_BUSY_END(region);
+                continue;
+            }
+            compact_solution_t* current = best == &candidates[0] ? &candidates[1] : &candidates[0];
+            int makespan = group_width > 1
+                ? dispatch_pipeline_decode(local, &pipelines[group], current, rules[i], &scratch)
+                : dispatch_rollout(local, current, rules[i], 1, &scratch);
+
+            // A group sees its rules in increasing order, so ties keep the earlier rule
+            if (!best || makespan < best->makespan) {
+                best = current;
+                best_rule = i;
+            }
+            INSTR_BUSY_END(region);
+        }
 
-            results[i].makespan = makespan;
-            results[i].rule_used = rules[i];
+        INSTR_REGION_END(region);
+        if (!selects && group < groups) {
+            slots[group].best = best;
+            slots[group].rule = best_rule;
         }
-    }
 
-    // Find best result
-    int best_idx = 0;
-    for (int i = 1; i < num_rules; i++) {
-        if (results[i].makespan < results[best_idx].makespan) {
-            best_idx = i;
+        // Decoded before any thread releases its buffers
+#pragma omp barrier
+#pragma omp single
+        if (!failed) {
+            int winner = -1;
+            for (int g = 0; g < groups; g++) {
+                if (slots[g].best
+                    && (winner < 0 || slots[g].best->makespan < slots[winner].best->makespan
+                        || (slots[g].best->makespan == slots[winner].best->makespan
+                            && slots[g].rule < slots[winner].rule))) {
+                    winner = g;
+                }
+            }
+            jobshop_solution_decode(solution, jss, slots[winner].best);
         }
+        arena_destroy(&thread_arena);
     }
 
-    // Copy best solution
-    memcpy(solution, &temp_solutions[best_idx], sizeof(jobshop_solution_t));
-    return results[best_idx].makespan;
+    free(slots);
+    free(pipelines);
+    return failed ? -1 : solution->makespan;
 }
 
-int solve_parallel(const jobshop_t* jss, jobshop_solution_t* solution, int num_threads) {
-    return solve_multi_pass_parallel(jss, solution, num_threads);
+int solve_parallel(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config) {
+    int makespan;
+    const char* phase = "rules";
+    if (config->warm_start) {
+        jobshop_solution_copy(solution, config->warm_start);
+        makespan = solution->makespan;
+        phase = "cache";
+    } else if (jss->flow_shop) {
+        makespan = solve_neh(jss, solution);
+        phase = "neh";
+    } else {
+        makespan = solve_multi_pass_parallel(jss, solution, config->num_threads, config->seed);
+    }
+    if (makespan >= 0) {
+        anytime_publish(config->anytime, makespan, phase);
+    }
+    if (makespan >= 0 && jss->flow_shop && config->ig_iterations > 0) {
+        makespan = solve_iterated_greedy(jss, solution, config);
+    }
+    if (makespan >= 0 && config->restarts > 0) {
+        makespan = solve_grasp(jss, solution, config);
+    }
+    if (makespan >= 0 && config->ga_generations > 0) {
+        makespan = solve_genetic(jss, solution, config);
+    }
+    if (makespan >= 0 && config->tabu_iterations > 0) {
+        makespan = tabu_search(jss, solution, config);
+    }
+    return makespan;
 }
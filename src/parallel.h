@@ -3,6 +3,7 @@
 
 #include "jobshop.h"
 
-int solve_parallel(const jobshop_t* jss, jobshop_solution_t* solution, int num_threads);
+int solve_multi_pass_parallel(const jobshop_t* jss, jobshop_solution_t* solution, int num_threads, uint64_t seed);
+int solve_parallel(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config);
 
 #endif
@@ -0,0 +1,252 @@
+#define _POSIX_C_SOURCE 200809L
+#include "portfolio.h"
+#include "anytime.h"
+#include "flowshop.h"
+#include "genetic.h"
+#include "grasp.h"
+#include "jobshop.h"
+#include "parallel.h"
+#include "rng.h"
+#include "sequential.h"
+#include "tabu.h"
+#include "utils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PORTFOLIO_EMPTY UINT64_MAX
+
+// Mapped by the parent before forking, so every worker sees the same pages.
+// Each worker owns two schedule buffers and fills the one the incumbent does
+// not reference, so a worker dying mid-copy never corrupts the published best.
+typedef struct {
+    uint64_t best; // makespan << 32 | worker << 1 | buffer, replaced by compare-and-swap
+    int num_workers;
+    int num_operations;
+    char padding[64 - sizeof(uint64_t) - 2 * sizeof(int)];
+} portfolio_region_t;
+
+// Buffer layout: rule used, then one start time per operation
+static int* portfolio_buffer(portfolio_region_t* region, int worker, int buffer) {
+    int* buffers = (int*)(region + 1);
+    return buffers + (size_t)(2 * worker + buffer) * (region->num_operations + 1);
+}
+
+static void portfolio_publish(portfolio_region_t* region, int worker, int* published_buffer,
+    const jobshop_solution_t* solution, FILE* progress, const anytime_t* anytime, const char* phase) {
+    uint64_t makespan = (uint64_t)solution->makespan;
+    uint64_t current = __atomic_load_n(&region->best, __ATOMIC_ACQUIRE);
+    if ((current >> 32) <= makespan) {
+        return;
+    }
+
+    int buffer = 1 - *published_buffer;
+    int* data = portfolio_buffer(region, worker, buffer);
+    data[0] = solution->rule_used;
+    for (int op = 0; op < solution->num_operations; op++) {
+        data[op + 1] = solution->schedule[op].start_time;
+    }
+
+    // The release order makes the buffer visible before the incumbent that names it
+    uint64_t packed = makespan << 32 | (uint64_t)worker << 1 | (uint64_t)buffer;
+    while ((current >> 32) > makespan) {
+        if (__atomic_compare_exchange_n(&region->best, &current, packed, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+            *published_buffer = buffer;
+            if (progress) {
+                fprintf(progress, "Progress:\t %.6fs\t %d\t %s/%d\n", anytime_elapsed(anytime), solution->makespan,
+                    phase, worker);
+                fflush(progress);
+            }
+            return;
+        }
+    }
+}
+
+// Runs in the child. Worker 0 keeps the configured seed, so one worker
+// reproduces a plain run; the others draw theirs from the worker id.
+static int portfolio_worker(const jobshop_t* jss, const solver_config_t* config, execution_mode_t mode,
+    portfolio_region_t* region, int worker) {
+    solver_config_t worker_config = *config;
+    uint64_t stream = (uint64_t)worker;
+    worker_config.seed = worker == 0 ? config->seed : config->seed ^ splitmix64(&stream);
+    worker_config.num_threads = mode == MODE_SEQUENTIAL ? 1 : max(1, config->num_threads / region->num_workers);
+    if (worker_config.num_threads == 1) {
+        worker_config.tabu_parallel = 0;
+    }
+
+    // Only improvements of the shared incumbent are reported
+    FILE* progress = NULL;
+    if (config->anytime) {
+        progress = config->anytime->progress;
+        config->anytime->progress = NULL;
+    }
+
+    arena_t arena;
+    arena_init(&arena, 0);
+    jobshop_solution_t solution;
+    if (jobshop_solution_init(&solution, &arena, jss) < 0) {
+        arena_destroy(&arena);
+        return -1;
+    }
+
+    int published_buffer = 1;
+    int makespan;
+    const char* phase = config->warm_start ? "cache" : "rules";
+    if (config->warm_start) {
+        jobshop_solution_copy(&solution, config->warm_start);
+        makespan = solution.makespan;
+    } else if (jss->flow_shop) {
+        makespan = solve_neh(jss, &solution);
+        phase = "neh";
+    } else if (worker_config.num_threads > 1) {
+        makespan = solve_multi_pass_parallel(jss, &solution, worker_config.num_threads, worker_config.seed);
+    } else {
+        makespan = solve_multi_pass(jss, &solution, worker_config.seed);
+    }
+    if (makespan >= 0) {
+        anytime_publish(config->anytime, makespan, phase);
+        portfolio_publish(region, worker, &published_buffer, &solution, progress, config->anytime, phase);
+    }
+    if (makespan >= 0 && jss->flow_shop && config->ig_iterations > 0) {
+        makespan = solve_iterated_greedy(jss, &solution, &worker_config);
+        portfolio_publish(region, worker, &published_buffer, &solution, progress, config->anytime, "ig");
+    }
+    if (makespan >= 0 && config->restarts > 0) {
+        makespan = solve_grasp(jss, &solution, &worker_config);
+        portfolio_publish(region, worker, &published_buffer, &solution, progress, config->anytime, "grasp");
+    }
+    if (makespan >= 0 && config->ga_generations > 0) {
+        makespan = solve_genetic(jss, &solution, &worker_config);
+        portfolio_publish(region, worker, &published_buffer, &solution, progress, config->anytime, "ga");
+    }
+    if (makespan >= 0 && config->tabu_iterations > 0) {
+        makespan = tabu_search(jss, &solution, &worker_config);
+        portfolio_publish(region, worker, &published_buffer, &solution, progress, config->anytime, "tabu");
+    }
+
+    arena_destroy(&arena);
+    return makespan;
+}
+
+static void portfolio_cancel(const pid_t* pids, int num_workers) {
+    for (int i = 0; i < num_workers; i++) {
+        if (pids[i] > 0) {
+            kill(pids[i], SIGINT);
+        }
+    }
+}
+
+int solve_portfolio(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config,
+    execution_mode_t mode, int num_workers) {
+    size_t size = sizeof(portfolio_region_t) + 2 * (size_t)num_workers * (jss->num_operations + 1) * sizeof(int);
+
+    // The name only lives until the mapping exists; nothing is left behind on a crash
+    char name[64];
+    snprintf(name, sizeof(name), "/jss-portfolio-%ld", (long)getpid());
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create shared memory '%s': %s\n", name, strerror(errno));
+        return -1;
+    }
+    shm_unlink(name);
+    if (ftruncate(fd, (off_t)size) < 0) {
+        fprintf(stderr, "Error: Cannot size shared memory: %s\n", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    portfolio_region_t* region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map shared memory: %s\n", strerror(errno));
+        return -1;
+    }
+    region->best = PORTFOLIO_EMPTY;
+    region->num_workers = num_workers;
+    region->num_operations = jss->num_operations;
+
+    // Buffered output would otherwise be written once per process
+    fflush(stdout);
+    fflush(stderr);
+
+    // Unforked slots stay 0, so cancelling and reaping never see a stale pid
+    pid_t pids[MAX_PORTFOLIO_WORKERS] = { 0 };
+    int running = 0;
+    for (int i = 0; i < num_workers; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            int makespan = portfolio_worker(jss, config, mode, region, i);
+            _exit(makespan >= 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        if (pids[i] < 0) {
+            fprintf(stderr, "Error: Cannot fork portfolio worker %d: %s\n", i, strerror(errno));
+            pids[i] = 0;
+            break;
+        }
+        running++;
+    }
+
+    // An incumbent at the lower bound ends the whole portfolio
+    int lower_bound = config->anytime ? config->anytime->lower_bound : 0;
+    int failures = 0;
+    while (running > 0) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < num_workers; i++) {
+            if (pids[i] == pid) {
+                pids[i] = 0;
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+                    fprintf(stderr, "Warning: Portfolio worker %d failed%s\n", i,
+                        WIFSIGNALED(status) ? " (killed by a signal)" : "");
+                    failures++;
+                }
+            }
+        }
+        running--;
+
+        uint64_t best = __atomic_load_n(&region->best, __ATOMIC_ACQUIRE);
+        if (best != PORTFOLIO_EMPTY && lower_bound > 0 && (int)(best >> 32) <= lower_bound) {
+            portfolio_cancel(pids, num_workers);
+        }
+    }
+
+    // Latches a deadline or Ctrl-C seen while waiting, so the caller reports it
+    anytime_expired(config->anytime);
+
+    uint64_t best = __atomic_load_n(&region->best, __ATOMIC_ACQUIRE);
+    if (best == PORTFOLIO_EMPTY) {
+        fprintf(stderr, "Error: No portfolio worker produced a schedule (%d failed)\n", failures);
+        munmap(region, size);
+        return -1;
+    }
+
+    const int* data = portfolio_buffer(region, (int)(best >> 1 & 0x7fffffff), (int)(best & 1));
+    solution->num_jobs = jss->num_jobs;
+    solution->num_machines = jss->num_machines;
+    solution->num_operations = jss->num_operations;
+    solution->job_offsets = jss->job_offsets;
+    solution->rule_used = (dispatch_rule_t)data[0];
+    solution->makespan = 0;
+    for (int op = 0; op < jss->num_operations; op++) {
+        solution->schedule[op].machine_id = jss->machines[op];
+        solution->schedule[op].start_time = data[op + 1];
+        solution->schedule[op].end_time = data[op + 1] + jss->times[op];
+        solution->makespan = max(solution->makespan, solution->schedule[op].end_time);
+    }
+    munmap(region, size);
+
+    anytime_publish(config->anytime, solution->makespan, "portfolio");
+    return solution->makespan;
+}
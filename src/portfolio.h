@@ -0,0 +1,14 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "jobshop.h"
+
+#define MAX_PORTFOLIO_WORKERS 256
+
+// Forks num_workers processes that run the configured pipeline with their own
+// seeds and share the incumbent through a shared memory region. A worker that
+// crashes only loses its own search; the parent writes the best schedule.
+int solve_portfolio(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config,
+    execution_mode_t mode, int num_workers);
+
+#endif
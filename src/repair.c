@@ -0,0 +1,501 @@
+#define _POSIX_C_SOURCE 200809L
+#include "repair.h"
+#include "arena.h"
+#include "flowshop.h"
+#include "graph.h"
+#include "jobshop.h"
+#include "utils.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int grow_ints(int** array, size_t count) {
+    int* grown = realloc(*array, count * sizeof(int));
+    if (!grown) {
+        return -1;
+    }
+    *array = grown;
+    return 0;
+}
+
+// Operation arrays grow geometrically, so inserting a job is amortized O(its length)
+static int repair_reserve_operations(repair_state_t* state, int count) {
+    if (count <= state->op_capacity) {
+        return 0;
+    }
+    int capacity = state->op_capacity * 2 > count ? state->op_capacity * 2 : count;
+    size_t size = (size_t)capacity;
+    if (grow_ints(&state->jss.machines, size) < 0 || grow_ints(&state->jss.times, size) < 0
+        || grow_ints(&state->jss.remaining_work, size) < 0 || grow_ints(&state->graph.job_of, size) < 0
+        || grow_ints(&state->graph.machine_prev, size) < 0 || grow_ints(&state->graph.machine_next, size) < 0
+        || grow_ints(&state->graph.heads, size) < 0) {
+        return -1;
+    }
+    unsigned char* queued = realloc(state->queued, size);
+    if (!queued) {
+        return -1;
+    }
+    state->queued = queued;
+    memset(state->queued + state->op_capacity, 0, size - (size_t)state->op_capacity);
+    uint64_t* heap = realloc(state->heap, size * sizeof(uint64_t));
+    if (!heap) {
+        return -1;
+    }
+    state->heap = heap;
+    state->op_capacity = capacity;
+    return 0;
+}
+
+static int repair_reserve_jobs(repair_state_t* state, int count) {
+    if (count <= state->job_capacity) {
+        return 0;
+    }
+    int capacity = state->job_capacity * 2 > count ? state->job_capacity * 2 : count;
+    if (grow_ints(&state->jss.job_offsets, (size_t)capacity + 1) < 0) {
+        return -1;
+    }
+    unsigned char* removed = realloc(state->removed, (size_t)capacity);
+    if (!removed) {
+        return -1;
+    }
+    state->removed = removed;
+    memset(state->removed + state->job_capacity, 0, (size_t)(capacity - state->job_capacity));
+    state->job_capacity = capacity;
+    return 0;
+}
+
+// Keeps the given schedule as is; its machine order becomes the fixed sequencing
+int repair_init(repair_state_t* state, const jobshop_t* jss, const jobshop_solution_t* solution) {
+    memset(state, 0, sizeof(*state));
+    state->jss.num_jobs = jss->num_jobs;
+    state->jss.num_machines = jss->num_machines;
+    state->jss.num_operations = jss->num_operations;
+    state->graph.num_operations = jss->num_operations;
+    state->graph.num_machines = jss->num_machines;
+    state->graph.machine_first = malloc((size_t)jss->num_machines * sizeof(int));
+    state->machine_last = malloc((size_t)jss->num_machines * sizeof(int));
+    state->windows = calloc((size_t)jss->num_machines, sizeof(repair_windows_t));
+    if (!state->graph.machine_first || !state->machine_last || !state->windows
+        || repair_reserve_operations(state, jss->num_operations) < 0 || repair_reserve_jobs(state, jss->num_jobs) < 0) {
+        repair_destroy(state);
+        return -1;
+    }
+
+    size_t n = (size_t)jss->num_operations;
+    memcpy(state->jss.job_offsets, jss->job_offsets, ((size_t)jss->num_jobs + 1) * sizeof(int));
+    memcpy(state->jss.machines, jss->machines, n * sizeof(int));
+    memcpy(state->jss.times, jss->times, n * sizeof(int));
+    memcpy(state->jss.remaining_work, jss->remaining_work, n * sizeof(int));
+    for (int job = 0; job < jss->num_jobs; job++) {
+        for (int op = jss->job_offsets[job]; op < jss->job_offsets[job + 1]; op++) {
+            state->graph.job_of[op] = job;
+        }
+    }
+    if (graph_from_solution(&state->graph, &state->jss, solution) < 0) {
+        repair_destroy(state);
+        return -1;
+    }
+    for (int op = 0; op < jss->num_operations; op++) {
+        state->graph.heads[op] = solution->schedule[op].start_time;
+    }
+    for (int m = 0; m < jss->num_machines; m++) {
+        int last = state->graph.machine_first[m];
+        while (last >= 0 && state->graph.machine_next[last] >= 0) {
+            last = state->graph.machine_next[last];
+        }
+        state->machine_last[m] = last;
+    }
+    state->rule_used = solution->rule_used;
+    state->makespan = solution->makespan;
+    return 0;
+}
+
+void repair_destroy(repair_state_t* state) {
+    free(state->jss.job_offsets);
+    free(state->jss.machines);
+    free(state->jss.times);
+    free(state->jss.remaining_work);
+    free(state->graph.job_of);
+    free(state->graph.machine_prev);
+    free(state->graph.machine_next);
+    free(state->graph.machine_first);
+    free(state->graph.heads);
+    free(state->machine_last);
+    free(state->removed);
+    free(state->queued);
+    free(state->heap);
+    if (state->windows) {
+        for (int m = 0; m < state->jss.num_machines; m++) {
+            free(state->windows[m].from);
+            free(state->windows[m].to);
+        }
+    }
+    free(state->windows);
+    memset(state, 0, sizeof(*state));
+}
+
+static inline uint64_t repair_key(const repair_state_t* state, int op) {
+    return (uint64_t)(uint32_t)state->graph.heads[op] << 32 | (uint32_t)op;
+}
+
+// Keyed by the start before the change: a topological order of the fixed
+// graph, so with positive durations every operation is recomputed once
+static void repair_push(repair_state_t* state, int op, int end_changed) {
+    if (op < 0) {
+        return;
+    }
+    if (state->queued[op]) {
+        state->queued[op] = end_changed ? 2 : state->queued[op];
+        return;
+    }
+    state->queued[op] = end_changed ? 2 : 1;
+    uint64_t key = repair_key(state, op);
+    int i = state->heap_count++;
+    while (i > 0 && state->heap[(i - 1) / 2] > key) {
+        state->heap[i] = state->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    state->heap[i] = key;
+}
+
+static int repair_pop(repair_state_t* state) {
+    int op = (int)(state->heap[0] & 0xffffffffu);
+    uint64_t last = state->heap[--state->heap_count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= state->heap_count) {
+            break;
+        }
+        if (child + 1 < state->heap_count && state->heap[child + 1] < state->heap[child]) {
+            child++;
+        }
+        if (state->heap[child] >= last) {
+            break;
+        }
+        state->heap[i] = state->heap[child];
+        i = child;
+    }
+    if (state->heap_count > 0) {
+        state->heap[i] = last;
+    }
+    return op;
+}
+
+// Earliest start after both predecessors that overlaps no downtime of the machine
+static int repair_earliest(const repair_state_t* state, int op) {
+    const jobshop_t* jss = &state->jss;
+    const schedule_graph_t* graph = &state->graph;
+    int start = 0;
+    int prev = graph_job_prev(graph, jss, op);
+    if (prev >= 0) {
+        start = graph->heads[prev] + jss->times[prev];
+    }
+    prev = graph->machine_prev[op];
+    if (prev >= 0) {
+        start = max(start, graph->heads[prev] + jss->times[prev]);
+    }
+
+    // Sorted by from, so one pass suffices and it ends at the first window after the operation
+    const repair_windows_t* windows = &state->windows[jss->machines[op]];
+    int length = max(jss->times[op], 1);
+    for (int w = 0; w < windows->count && windows->from[w] < start + length; w++) {
+        if (start < windows->to[w]) {
+            start = windows->to[w];
+        }
+    }
+    return start;
+}
+
+// Recomputes the queued operations and everything they push; the makespan is
+// read off the last operation of each machine
+static int repair_propagate(repair_state_t* state) {
+    const jobshop_t* jss = &state->jss;
+    schedule_graph_t* graph = &state->graph;
+    state->touched = 0;
+    while (state->heap_count > 0) {
+        int op = repair_pop(state);
+        int end_changed = state->queued[op] == 2;
+        state->queued[op] = 0;
+        state->touched++;
+        int start = repair_earliest(state, op);
+        if (start != graph->heads[op] || end_changed) {
+            graph->heads[op] = start;
+            repair_push(state, graph_job_next(graph, jss, op), 0);
+            repair_push(state, graph->machine_next[op], 0);
+        }
+    }
+
+    int makespan = 0;
+    for (int m = 0; m < jss->num_machines; m++) {
+        int last = state->machine_last[m];
+        if (last >= 0) {
+            makespan = max(makespan, graph->heads[last] + jss->times[last]);
+        }
+    }
+    state->makespan = makespan;
+    return makespan;
+}
+
+// Machine unavailable in [from, to): operations overlapping it move past it,
+// found by walking back from the machine's last operation
+int repair_machine_down(repair_state_t* state, int machine, int from, int to) {
+    const jobshop_t* jss = &state->jss;
+    if (machine < 0 || machine >= jss->num_machines || from < 0 || to <= from) {
+        fprintf(stderr, "Error: Invalid downtime [%d, %d) on machine %d\n", from, to, machine);
+        return -1;
+    }
+
+    repair_windows_t* windows = &state->windows[machine];
+    if (windows->count == windows->capacity) {
+        int capacity = windows->capacity > 0 ? windows->capacity * 2 : 4;
+        if (grow_ints(&windows->from, (size_t)capacity) < 0 || grow_ints(&windows->to, (size_t)capacity) < 0) {
+            fprintf(stderr, "Error: Out of memory\n");
+            return -1;
+        }
+        windows->capacity = capacity;
+    }
+    int w = windows->count++;
+    while (w > 0 && windows->from[w - 1] > from) {
+        windows->from[w] = windows->from[w - 1];
+        windows->to[w] = windows->to[w - 1];
+        w--;
+    }
+    windows->from[w] = from;
+    windows->to[w] = to;
+
+    for (int op = state->machine_last[machine]; op >= 0; op = state->graph.machine_prev[op]) {
+        int start = state->graph.heads[op];
+        if (start + max(jss->times[op], 1) <= from) {
+            break;
+        }
+        if (start < to) {
+            repair_push(state, op, 0);
+        }
+    }
+    return repair_propagate(state);
+}
+
+int repair_set_duration(repair_state_t* state, int job, int op_idx, int time) {
+    jobshop_t* jss = &state->jss;
+    if (job < 0 || job >= jss->num_jobs || state->removed[job] || op_idx < 0
+        || op_idx >= jss->job_offsets[job + 1] - jss->job_offsets[job] || time < 0) {
+        fprintf(stderr, "Error: Invalid duration %d for job %d, operation %d\n", time, job, op_idx);
+        return -1;
+    }
+    int op = jss->job_offsets[job] + op_idx;
+    int delta = time - jss->times[op];
+    jss->times[op] = time;
+    for (int i = jss->job_offsets[job]; i <= op; i++) {
+        jss->remaining_work[i] += delta;
+    }
+    repair_push(state, op, 1);
+    return repair_propagate(state);
+}
+
+// Appends the job's operations to the end of their machines, so no existing
+// operation moves; returns the makespan, the job takes the next job id
+int repair_insert_job(repair_state_t* state, const int* machines, const int* times, int count) {
+    jobshop_t* jss = &state->jss;
+    if (count != jss->num_machines) {
+        fprintf(stderr, "Error: An inserted job needs %d operations, got %d\n", jss->num_machines, count);
+        return -1;
+    }
+    for (int k = 0; k < count; k++) {
+        if (machines[k] < 0 || machines[k] >= jss->num_machines || times[k] < 0) {
+            fprintf(stderr, "Error: Invalid operation %d (machine %d, time %d) of inserted job\n", k, machines[k],
+                times[k]);
+            return -1;
+        }
+    }
+    if (jss->num_operations > INT_MAX - count || repair_reserve_operations(state, jss->num_operations + count) < 0
+        || repair_reserve_jobs(state, jss->num_jobs + 1) < 0) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return -1;
+    }
+
+    int job = jss->num_jobs;
+    int first = jss->num_operations;
+    schedule_graph_t* graph = &state->graph;
+    int remaining = 0;
+    for (int k = count - 1; k >= 0; k--) {
+        remaining += times[k];
+        jss->remaining_work[first + k] = remaining;
+    }
+    for (int k = 0; k < count; k++) {
+        int op = first + k;
+        int machine = machines[k];
+        jss->machines[op] = machine;
+        jss->times[op] = times[k];
+        graph->job_of[op] = job;
+        graph->heads[op] = 0;
+        graph->machine_prev[op] = state->machine_last[machine];
+        graph->machine_next[op] = -1;
+        if (state->machine_last[machine] >= 0) {
+            graph->machine_next[state->machine_last[machine]] = op;
+        } else {
+            graph->machine_first[machine] = op;
+        }
+        state->machine_last[machine] = op;
+    }
+    jss->num_jobs++;
+    jss->num_operations += count;
+    jss->job_offsets[jss->num_jobs] = jss->num_operations;
+    graph->num_operations = jss->num_operations;
+    state->removed[job] = 0;
+
+    for (int k = 0; k < count; k++) {
+        repair_push(state, first + k, 1);
+    }
+    return repair_propagate(state);
+}
+
+// Unlinks the job's operations; their machine successors may start earlier
+int repair_remove_job(repair_state_t* state, int job) {
+    const jobshop_t* jss = &state->jss;
+    if (job < 0 || job >= jss->num_jobs || state->removed[job]) {
+        fprintf(stderr, "Error: Invalid job %d to remove\n", job);
+        return -1;
+    }
+    if (jss->num_jobs - state->num_removed == 1) {
+        fprintf(stderr, "Error: Cannot remove the last job\n");
+        return -1;
+    }
+
+    schedule_graph_t* graph = &state->graph;
+    for (int op = jss->job_offsets[job]; op < jss->job_offsets[job + 1]; op++) {
+        int machine = jss->machines[op];
+        int before = graph->machine_prev[op];
+        int after = graph->machine_next[op];
+        if (before >= 0) {
+            graph->machine_next[before] = after;
+        } else {
+            graph->machine_first[machine] = after;
+        }
+        if (after >= 0) {
+            graph->machine_prev[after] = before;
+        } else {
+            state->machine_last[machine] = before;
+        }
+        graph->machine_prev[op] = graph->machine_next[op] = -1;
+        repair_push(state, after, 0);
+    }
+    state->removed[job] = 1;
+    state->num_removed++;
+    return repair_propagate(state);
+}
+
+// Snapshot of the remaining jobs, renumbered in order, and their schedule
+int repair_export(const repair_state_t* state, jobshop_t* jss, jobshop_solution_t* solution, arena_t* arena) {
+    const jobshop_t* live = &state->jss;
+    if (jobshop_init(jss, arena, live->num_jobs - state->num_removed, live->num_machines) < 0
+        || jobshop_solution_init(solution, arena, jss) < 0) {
+        return -1;
+    }
+    int op = 0;
+    for (int job = 0; job < live->num_jobs; job++) {
+        if (state->removed[job]) {
+            continue;
+        }
+        for (int source = live->job_offsets[job]; source < live->job_offsets[job + 1]; source++, op++) {
+            jss->machines[op] = live->machines[source];
+            jss->times[op] = live->times[source];
+            jss->remaining_work[op] = live->remaining_work[source];
+            solution->schedule[op].machine_id = live->machines[source];
+            solution->schedule[op].start_time = state->graph.heads[source];
+            solution->schedule[op].end_time = state->graph.heads[source] + live->times[source];
+        }
+    }
+    jss->flow_shop = jobshop_is_flow_shop(jss);
+    solution->makespan = state->makespan;
+    solution->rule_used = state->rule_used;
+    return 0;
+}
+
+static double repair_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Applies a change script, one change per line ('#' starts a comment):
+//   down   <machine> <from> <to>
+//   time   <job> <operation> <duration>
+//   insert <machine> <time> ... (one pair per machine)
+//   remove <job>
+// Each change is reported with its makespan, operations recomputed and time.
+int repair_run_script(repair_state_t* state, const char* filename, FILE* out) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
+        return -1;
+    }
+
+    int num_machines = state->jss.num_machines;
+    // Parsed fields, then an inserted job's machines and times
+    int* values = malloc((size_t)(4 * num_machines + 1) * sizeof(int));
+    char* line = NULL;
+    size_t line_capacity = 0;
+    int line_number = 0;
+    int changes = 0;
+    int status = values ? 0 : -1;
+    while (status == 0 && getline(&line, &line_capacity, file) >= 0) {
+        line_number++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        char* cursor = line;
+        char kind[16];
+        int consumed = 0;
+        if (sscanf(cursor, "%15s%n", kind, &consumed) != 1) {
+            continue;
+        }
+        cursor += consumed;
+
+        // Every field is an integer; an insert has two per machine
+        int count = 0;
+        int expected = strcmp(kind, "down") == 0 || strcmp(kind, "time") == 0 ? 3
+            : strcmp(kind, "insert") == 0                                    ? 2 * num_machines
+            : strcmp(kind, "remove") == 0                                    ? 1
+                                                                             : -1;
+        while (count <= expected && sscanf(cursor, "%d%n", &values[count], &consumed) == 1) {
+            cursor += consumed;
+            count++;
+        }
+        if (expected < 0 || count != expected) {
+            fprintf(stderr, "Error: Invalid change on line %d of '%s'\n", line_number, filename);
+            status = -1;
+            break;
+        }
+
+        double start = repair_now();
+        int makespan;
+        if (strcmp(kind, "down") == 0) {
+            makespan = repair_machine_down(state, values[0], values[1], values[2]);
+        } else if (strcmp(kind, "time") == 0) {
+            makespan = repair_set_duration(state, values[0], values[1], values[2]);
+        } else if (strcmp(kind, "remove") == 0) {
+            makespan = repair_remove_job(state, values[0]);
+        } else {
+            int* machines = values + 2 * num_machines + 1;
+            int* times = machines + num_machines;
+            for (int k = 0; k < num_machines; k++) {
+                machines[k] = values[2 * k];
+                times[k] = values[2 * k + 1];
+            }
+            makespan = repair_insert_job(state, machines, times, num_machines);
+        }
+        double elapsed = repair_now() - start;
+        if (makespan < 0) {
+            status = -1;
+            break;
+        }
+        changes++;
+        fprintf(out, "Change %d:\t %s, makespan %d, %ld operations in %.6fs\n", changes, kind, makespan,
+            state->touched, elapsed);
+    }
+
+    free(line);
+    free(values);
+    fclose(file);
+    return status;
+}
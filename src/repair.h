@@ -0,0 +1,48 @@
+#ifndef REPAIR_H
+#define REPAIR_H
+
+#include "arena.h"
+#include "graph.h"
+#include "jobshop.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Downtime of one machine, sorted by from; operations never overlap [from, to)
+typedef struct {
+    int* from;
+    int* to;
+    int count;
+    int capacity;
+} repair_windows_t;
+
+// A schedule kept live across changes instead of re-solved. Machine
+// sequences stay fixed: after a change only the operations reachable from it
+// on the disjunctive graph are recomputed, in order of their previous start
+// times, so the cost follows the size of the disturbance, not the instance.
+typedef struct {
+    jobshop_t jss; // Growable copy; removed jobs keep their operations, unlinked
+    schedule_graph_t graph; // Machine sequences, heads hold the current start times
+    int* machine_last; // Last operation per machine, -1 if none
+    unsigned char* removed; // Per job
+    unsigned char* queued; // Per operation: 1 queued, 2 queued with a changed end
+    uint64_t* heap; // (start before the change, operation), smallest first
+    int heap_count;
+    repair_windows_t* windows; // Per machine
+    int op_capacity;
+    int job_capacity;
+    int num_removed;
+    dispatch_rule_t rule_used;
+    int makespan;
+    long touched; // Operations recomputed by the last change
+} repair_state_t;
+
+int repair_init(repair_state_t* state, const jobshop_t* jss, const jobshop_solution_t* solution);
+int repair_machine_down(repair_state_t* state, int machine, int from, int to);
+int repair_set_duration(repair_state_t* state, int job, int op_idx, int time);
+int repair_insert_job(repair_state_t* state, const int* machines, const int* times, int count);
+int repair_remove_job(repair_state_t* state, int job);
+int repair_export(const repair_state_t* state, jobshop_t* jss, jobshop_solution_t* solution, arena_t* arena);
+int repair_run_script(repair_state_t* state, const char* filename, FILE* out);
+void repair_destroy(repair_state_t* state);
+
+#endif
@@ -1,147 +1,78 @@
 #include "sequential.h"
+#include "anytime.h"
+#include "dispatch.h"
+#include "flowshop.h"
+#include "genetic.h"
+#include "grasp.h"
 #include "jobshop.h"
+#include "tabu.h"
 #include "utils.h"
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
-static int solve_with_dispatch_rule_sequential(const jobshop_t* jss, jobshop_solution_t* solution, dispatch_rule_t rule) {
-    int machine_completion_time[MAX_MACHINES] = { 0 };
-    int job_next_operation[MAX_JOBS] = { 0 };
-    int operations_completed = 0;
-    int total_operations = jss->num_jobs * jss->num_machines;
-
-    solution->num_jobs = jss->num_jobs;
-    solution->num_machines = jss->num_machines;
-
-    while (operations_completed < total_operations) {
-        // Find all ready operations using struct-of-arrays
-        operation_batch_t ready_ops = { .count = 0 };
-
-        for (int job_id = 0; job_id < jss->num_jobs; job_id++) {
-            int op_idx = job_next_operation[job_id];
-            if (op_idx < jss->num_machines) {
-                int idx = ready_ops.count;
-                ready_ops.job_ids[idx] = job_id;
-                ready_ops.op_ids[idx] = op_idx;
-                ready_ops.machine_ids[idx] = jss->machines[job_id][op_idx];
-                ready_ops.processing_times[idx] = jss->times[job_id][op_idx];
-                ready_ops.remaining_works[idx] = calculate_remaining_work(jss, job_id, op_idx);
-
-                // Calculate priority based on dispatch rule
-                switch (rule) {
-                case SHORTEST_PROCESSING_TIME:
-                    ready_ops.priorities[idx] = ready_ops.processing_times[idx];
-                    break;
-                case LONGEST_PROCESSING_TIME:
-                    ready_ops.priorities[idx] = -ready_ops.processing_times[idx];
-                    break;
-                case SHORTEST_REMAINING_TIME:
-                    ready_ops.priorities[idx] = ready_ops.remaining_works[idx];
-                    break;
-                case MOST_WORK_REMAINING:
-                    ready_ops.priorities[idx] = -ready_ops.remaining_works[idx];
-                    break;
-                case FIRST_IN_FIRST_OUT:
-                    ready_ops.priorities[idx] = job_id;
-                    break;
-                case MOST_OPERATIONS_REMAINING:
-                    ready_ops.priorities[idx] = -(jss->num_machines - op_idx);
-                    break;
-                case RANDOM:
-                    ready_ops.priorities[idx] = rand() % 1000;
-                    break;
-                default:
-                    ready_ops.priorities[idx] = job_id; // FIFO as fallback
-                }
-                ready_ops.count++;
-            }
-        }
-
-        // Find operation with best priority (minimum value)
-        int best_idx = 0;
-        for (int i = 1; i < ready_ops.count; i++) {
-            if (ready_ops.priorities[i] < ready_ops.priorities[best_idx]) {
-                best_idx = i;
-            }
-        }
-
-        // Schedule the highest priority operation
-        int job_id = ready_ops.job_ids[best_idx];
-        int op_idx = ready_ops.op_ids[best_idx];
-        int machine_id = ready_ops.machine_ids[best_idx];
-        int processing_time = ready_ops.processing_times[best_idx];
-
-        // Calculate start time
-        int job_completion_time = 0;
-        if (op_idx > 0) {
-            job_completion_time = solution->schedule[job_id][op_idx - 1].end_time;
-        }
-
-        int start_time = max(machine_completion_time[machine_id], job_completion_time);
-
-        // Store in solution
-        solution->schedule[job_id][op_idx].machine_id = machine_id;
-        solution->schedule[job_id][op_idx].start_time = start_time;
-        solution->schedule[job_id][op_idx].end_time = start_time + processing_time;
-
-        // Update completion times
-        machine_completion_time[machine_id] = start_time + processing_time;
-        job_next_operation[job_id]++;
-        operations_completed++;
+int solve_multi_pass(const jobshop_t* jss, jobshop_solution_t* solution, uint64_t seed) {
+    const dispatch_rule_t* rules = multi_pass_rules;
+    int num_rules = DISPATCH_RULE_COUNT;
+
+    // Two compact buffers: the best rollout so far and the one being built
+    arena_t arena;
+    arena_init(&arena, 0);
+    dispatch_scratch_t scratch;
+    compact_solution_t candidates[2];
+    if (dispatch_scratch_init(&scratch, &arena, jss) < 0 || compact_solution_init(&candidates[0], &arena, jss) < 0
+        || compact_solution_init(&candidates[1], &arena, jss) < 0) {
+        arena_destroy(&arena);
+        return -1;
     }
 
-    // Calculate makespan
-    int makespan = 0;
-    for (int job_id = 0; job_id < jss->num_jobs; job_id++) {
-        int job_end = solution->schedule[job_id][jss->num_machines - 1].end_time;
-        if (job_end > makespan) {
-            makespan = job_end;
+    // Keep the best by swapping buffers, never copying; ties keep the earlier rule
+    compact_solution_t* best = NULL;
+    for (int i = 0; i < num_rules; i++) {
+        compact_solution_t* current = best == &candidates[0] ? &candidates[1] : &candidates[0];
+        rng_seed(&scratch.rng, seed, i);
+        int makespan = dispatch_rollout(jss, current, rules[i], 1, &scratch);
+        if (!best || makespan < best->makespan) {
+            best = current;
         }
     }
 
-    solution->makespan = makespan;
-    return makespan;
+    jobshop_solution_decode(solution, jss, best);
+    arena_destroy(&arena);
+    return solution->makespan;
 }
 
-int solve_multi_pass(const jobshop_t* jss, jobshop_solution_t* solution) {
-    // Use solution summaries to track results
-    solution_summary_t results[DISPATCH_RULE_COUNT];
-    jobshop_solution_t temp_solutions[DISPATCH_RULE_COUNT];
-
-    // Try different dispatch rules
-    dispatch_rule_t rules[] = {
-        SHORTEST_PROCESSING_TIME,
-        LONGEST_PROCESSING_TIME,
-        SHORTEST_REMAINING_TIME,
-        MOST_WORK_REMAINING,
-        FIRST_IN_FIRST_OUT,
-        MOST_OPERATIONS_REMAINING,
-        RANDOM
-    };
-
-    int num_rules = sizeof(rules) / sizeof(rules[0]);
-
-    for (int i = 0; i < num_rules; i++) {
-        int makespan = solve_with_dispatch_rule_sequential(jss, &temp_solutions[i], rules[i]);
-
-        results[i].makespan = makespan;
-        results[i].rule_used = rules[i];
+int solve_sequential(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config) {
+    solver_config_t sequential_config = *config;
+    sequential_config.num_threads = 1;
+    sequential_config.tabu_parallel = 0;
+
+    int makespan;
+    const char* phase = "rules";
+    if (config->warm_start) {
+        jobshop_solution_copy(solution, config->warm_start);
+        makespan = solution->makespan;
+        phase = "cache";
+    } else if (jss->flow_shop) {
+        makespan = solve_neh(jss, solution);
+        phase = "neh";
+    } else {
+        makespan = solve_multi_pass(jss, solution, config->seed);
     }
-
-    // Find best result
-    int best_idx = 0;
-    for (int i = 1; i < num_rules; i++) {
-        if (results[i].makespan < results[best_idx].makespan) {
-            best_idx = i;
-        }
+    if (makespan >= 0) {
+        anytime_publish(config->anytime, makespan, phase);
     }
-
-    // Copy best solution
-    memcpy(solution, &temp_solutions[best_idx], sizeof(jobshop_solution_t));
-    return results[best_idx].makespan;
-}
-
-int solve_sequential(const jobshop_t* jss, jobshop_solution_t* solution) {
-    return solve_multi_pass(jss, solution);
+    if (makespan >= 0 && jss->flow_shop && config->ig_iterations > 0) {
+        makespan = solve_iterated_greedy(jss, solution, &sequential_config);
+    }
+    if (makespan >= 0 && config->restarts > 0) {
+        makespan = solve_grasp(jss, solution, &sequential_config);
+    }
+    if (makespan >= 0 && config->ga_generations > 0) {
+        makespan = solve_genetic(jss, solution, &sequential_config);
+    }
+    if (makespan >= 0 && config->tabu_iterations > 0) {
+        makespan = tabu_search(jss, solution, &sequential_config);
+    }
+    return makespan;
 }
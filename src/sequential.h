@@ -11,7 +11,8 @@ typedef enum {
     HEURISTIC_LWR = 4 // Least Work Remaining
 } heuristic_t;
 
-int solve_sequential(const jobshop_t* jss, jobshop_solution_t* solution);
+int solve_multi_pass(const jobshop_t* jss, jobshop_solution_t* solution, uint64_t seed);
+int solve_sequential(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config);
 int solve_sequential_with_heuristic(const jobshop_t* jss, jobshop_solution_t* solution, heuristic_t heuristic);
 int solve_best_heuristic(const jobshop_t* jss, jobshop_solution_t* solution);
 
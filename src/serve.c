@@ -0,0 +1,538 @@
+#define _POSIX_C_SOURCE 200809L
+#include "serve.h"
+#include "anytime.h"
+#include "arena.h"
+#include "bounds.h"
+#include "instance.h"
+#include "jobshop.h"
+#include "online.h"
+#include "parallel.h"
+#include "sequential.h"
+#include "utils.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t serve_stop = 0;
+static int serve_wake_fd = -1;
+
+// Also wakes the poll loop, so a signal between its check and poll is not lost
+static void serve_handle_signal(int signum) {
+    (void)signum;
+    serve_stop = 1;
+    char byte = 0;
+    ssize_t ignored = write(serve_wake_fd, &byte, 1);
+    (void)ignored;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// A connection with a request waiting to be read
+typedef struct {
+    int fd;
+    uint64_t ready_ns; // When poll saw it readable
+} serve_pending_t;
+
+// The poll loop owns idle connections; workers own a connection from the
+// moment they dequeue it until they close it or hand it back
+typedef struct {
+    const serve_options_t* options;
+    const solver_config_t* config;
+    int threads_per_request;
+    int listen_fd;
+    int wake[2]; // Pipe that wakes the poll loop when workers hand connections back
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    serve_pending_t queue[SERVE_MAX_CONNECTIONS]; // Ring, in readiness order
+    int queue_head;
+    int queue_count;
+    int returned[SERVE_MAX_CONNECTIONS];
+    int num_returned;
+    int connections;
+    int stopping;
+    long requests;
+    long failures;
+    latency_histogram_t queued;
+    latency_histogram_t solved;
+    // Poll loop state
+    int idle[SERVE_MAX_CONNECTIONS];
+    int num_idle;
+    struct pollfd fds[SERVE_MAX_CONNECTIONS + 2];
+} server_t;
+
+// Buffers kept across requests, so a warm worker allocates nothing for
+// instances no larger than the ones it has already served
+typedef struct {
+    server_t* server;
+    pthread_t thread;
+    arena_t arena;
+    char* buffer;
+    size_t capacity;
+} serve_worker_t;
+
+static void serve_close(server_t* server, int fd) {
+    close(fd);
+    pthread_mutex_lock(&server->lock);
+    server->connections--;
+    pthread_mutex_unlock(&server->lock);
+}
+
+// Kept-alive connections go back to the poll loop to wait for their next request
+static void serve_return(server_t* server, int fd) {
+    pthread_mutex_lock(&server->lock);
+    int stopping = server->stopping;
+    if (!stopping) {
+        server->returned[server->num_returned++] = fd;
+    }
+    pthread_mutex_unlock(&server->lock);
+    if (stopping) {
+        serve_close(server, fd);
+        return;
+    }
+    char byte = 0;
+    while (write(server->wake[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+}
+
+static int serve_reserve(serve_worker_t* worker, size_t size) {
+    if (size <= worker->capacity) {
+        return 0;
+    }
+    if (size > SERVE_MAX_REQUEST) {
+        return -1;
+    }
+    size_t capacity = worker->capacity * 2 > size ? worker->capacity * 2 : size;
+    capacity = capacity < SERVE_MAX_REQUEST ? capacity : SERVE_MAX_REQUEST;
+    char* buffer = realloc(worker->buffer, capacity);
+    if (!buffer) {
+        return -1;
+    }
+    worker->buffer = buffer;
+    worker->capacity = capacity;
+    return 0;
+}
+
+// One read once data arrives, -1 on error or when the request deadline
+// passes first, so a client that stalls mid-request cannot hold a worker
+static ssize_t serve_read_some(int fd, char* data, size_t count, uint64_t deadline_ns) {
+    for (;;) {
+        uint64_t now = now_ns();
+        if (now >= deadline_ns) {
+            return -1;
+        }
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int timeout_ms = (int)((deadline_ns - now + 999999) / 1000000);
+        int ready = poll(&pfd, 1, timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            return -1;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+        ssize_t got = read(fd, data, count);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        return got;
+    }
+}
+
+// Reads count bytes unless the stream ends first; returns the bytes read, -1 on error
+static ssize_t serve_read(int fd, char* data, size_t count, uint64_t deadline_ns) {
+    size_t done = 0;
+    while (done < count) {
+        ssize_t got = serve_read_some(fd, data + done, count - done, deadline_ns);
+        if (got < 0) {
+            return -1;
+        }
+        if (got == 0) {
+            break;
+        }
+        done += (size_t)got;
+    }
+    return (ssize_t)done;
+}
+
+static uint32_t serve_le32(const char* bytes) {
+    const unsigned char* b = (const unsigned char*)bytes;
+    return (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+}
+
+// Returns 1 with a request in the buffer, 0 when the client closed between
+// requests and -1 on a short, oversized, unreadable or late request
+static int serve_receive(serve_worker_t* worker, int fd, size_t* length, int* binary) {
+    if (serve_reserve(worker, JSSB_HEADER_SIZE) < 0) {
+        return -1;
+    }
+    uint64_t deadline_ns = now_ns() + (uint64_t)SERVE_RECEIVE_TIMEOUT * 1000000000ull;
+    ssize_t got = serve_read(fd, worker->buffer, 4, deadline_ns);
+    if (got <= 0) {
+        return (int)got;
+    }
+
+    if (got == 4 && memcmp(worker->buffer, JSSB_MAGIC, 4) == 0) {
+        *binary = 1;
+        if (serve_read(fd, worker->buffer + 4, JSSB_HEADER_SIZE - 4, deadline_ns) != JSSB_HEADER_SIZE - 4) {
+            return -1;
+        }
+        uint64_t operations = (uint64_t)serve_le32(worker->buffer + 8) * serve_le32(worker->buffer + 12);
+        if (operations == 0 || operations > (SERVE_MAX_REQUEST - JSSB_HEADER_SIZE) / (3 * sizeof(int32_t))) {
+            return -1;
+        }
+        size_t size = JSSB_HEADER_SIZE + (size_t)operations * 3 * sizeof(int32_t);
+        if (serve_reserve(worker, size) < 0
+            || serve_read(fd, worker->buffer + JSSB_HEADER_SIZE, size - JSSB_HEADER_SIZE, deadline_ns)
+                != (ssize_t)(size - JSSB_HEADER_SIZE)) {
+            return -1;
+        }
+        *length = size;
+        return 1;
+    }
+
+    *binary = 0;
+    size_t used = (size_t)got;
+    for (;;) {
+        if (used == worker->capacity && serve_reserve(worker, used + 1) < 0) {
+            return -1;
+        }
+        got = serve_read_some(fd, worker->buffer + used, worker->capacity - used, deadline_ns);
+        if (got < 0) {
+            return -1;
+        }
+        if (got == 0) {
+            break;
+        }
+        used += (size_t)got;
+    }
+    *length = used;
+    return 1;
+}
+
+// Solves one request and replies on the connection. Returns 1 when the
+// connection stays open for another binary request.
+static int serve_request(serve_worker_t* worker, int fd, uint64_t ready_ns) {
+    server_t* server = worker->server;
+    uint64_t dequeued_ns = now_ns();
+    size_t length = 0;
+    int binary = 0;
+    int received = serve_receive(worker, fd, &length, &binary);
+    if (received == 0) {
+        return 0;
+    }
+
+    uint64_t start_ns = now_ns();
+    arena_reset(&worker->arena);
+    jobshop_t jss;
+    jobshop_solution_t solution;
+    lower_bound_t bound;
+    const char* error = "Cannot read request";
+    int makespan = -1;
+    if (received > 0) {
+        error = "Invalid instance";
+        int loaded = binary ? load_jobshop_binary(worker->buffer, length, "request", &jss, &worker->arena)
+                            : parse_jobshop_text(worker->buffer, length, "request", &jss, &worker->arena);
+        if (loaded == 0) {
+            error = "Failed to solve instance (out of memory)";
+            if (jobshop_solution_init(&solution, &worker->arena, &jss) == 0
+                && compute_lower_bound(&jss, server->threads_per_request, &bound) == 0) {
+                solver_config_t config = *server->config;
+                config.num_threads = server->threads_per_request;
+                anytime_t anytime;
+                anytime_init(&anytime, server->options->time_limit, NULL);
+                anytime_set_lower_bound(&anytime, bound.value);
+                config.anytime = &anytime;
+                makespan = server->options->mode == MODE_SEQUENTIAL ? solve_sequential(&jss, &solution, &config)
+                                                                    : solve_parallel(&jss, &solution, &config);
+            }
+        }
+    }
+    uint64_t end_ns = now_ns();
+
+    pthread_mutex_lock(&server->lock);
+    server->requests++;
+    if (makespan < 0) {
+        server->failures++;
+    } else {
+        latency_record(&server->queued, dequeued_ns - ready_ns);
+        latency_record(&server->solved, end_ns - start_ns);
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    int reply = dup(fd);
+    FILE* out = reply >= 0 ? fdopen(reply, "w") : NULL;
+    if (!out) {
+        if (reply >= 0) {
+            close(reply);
+        }
+        return 0;
+    }
+    if (makespan >= 0) {
+        fprintf(out, "Queued:\t\t %.6fs\n", (dequeued_ns - ready_ns) / 1e9);
+        fprintf(out, "Solved in:\t %.6fs\n", (end_ns - start_ns) / 1e9);
+        fprintf(out, "Lower bound:\t %d\n", bound.value);
+        write_jobshop_solution(out, &solution);
+    } else {
+        fprintf(out, "Error: %s\n", error);
+    }
+    int written = !ferror(out);
+    written = fclose(out) == 0 && written;
+    return written && binary && makespan >= 0;
+}
+
+static void* serve_worker_main(void* arg) {
+    serve_worker_t* worker = arg;
+    server_t* server = worker->server;
+
+    // Forms this thread's OpenMP team once, so the first request finds it warm
+    fork_join_seconds(server->threads_per_request);
+
+    // Queued requests are still served after a stop
+    for (;;) {
+        pthread_mutex_lock(&server->lock);
+        while (server->queue_count == 0 && !server->stopping) {
+            pthread_cond_wait(&server->ready, &server->lock);
+        }
+        if (server->queue_count == 0) {
+            pthread_mutex_unlock(&server->lock);
+            break;
+        }
+        serve_pending_t pending = server->queue[server->queue_head];
+        server->queue_head = (server->queue_head + 1) % SERVE_MAX_CONNECTIONS;
+        server->queue_count--;
+        pthread_mutex_unlock(&server->lock);
+
+        if (serve_request(worker, pending.fd, pending.ready_ns)) {
+            serve_return(server, pending.fd);
+        } else {
+            serve_close(server, pending.fd);
+        }
+    }
+    return NULL;
+}
+
+static int serve_listen(const char* path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Error: Socket path '%s' is too long\n", path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    // A socket left by an earlier server is replaced, any other file is kept
+    struct stat info;
+    if (lstat(path, &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            fprintf(stderr, "Error: '%s' exists and is not a socket\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create socket: %s\n", strerror(errno));
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(fd, SERVE_BACKLOG) < 0
+        || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+        fprintf(stderr, "Error: Cannot listen on '%s': %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void serve_accept(server_t* server) {
+    for (;;) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            return;
+        }
+        pthread_mutex_lock(&server->lock);
+        int full = server->connections == SERVE_MAX_CONNECTIONS;
+        server->connections += !full;
+        pthread_mutex_unlock(&server->lock);
+        if (full) {
+            static const char busy[] = "Error: Too many connections\n";
+            ssize_t ignored = write(fd, busy, sizeof(busy) - 1);
+            (void)ignored;
+            close(fd);
+        } else {
+            server->idle[server->num_idle++] = fd;
+        }
+    }
+}
+
+// One poll over the listening socket, the wake pipe and every idle
+// connection; readable connections are queued for the workers
+static void serve_poll(server_t* server) {
+    int count = 2 + server->num_idle;
+    server->fds[0] = (struct pollfd) { .fd = server->listen_fd, .events = POLLIN };
+    server->fds[1] = (struct pollfd) { .fd = server->wake[0], .events = POLLIN };
+    for (int i = 0; i < server->num_idle; i++) {
+        server->fds[2 + i] = (struct pollfd) { .fd = server->idle[i], .events = POLLIN };
+    }
+    if (poll(server->fds, (nfds_t)count, -1) <= 0) {
+        return;
+    }
+    uint64_t ready_ns = now_ns();
+
+    // Drained before collecting, so a hand-back after this wakes the next poll
+    if (server->fds[1].revents) {
+        char bytes[64];
+        while (read(server->wake[0], bytes, sizeof(bytes)) > 0) {
+        }
+    }
+
+    pthread_mutex_lock(&server->lock);
+    int kept = 0;
+    int queued = 0;
+    for (int i = 0; i < server->num_idle; i++) {
+        if (server->fds[2 + i].revents) {
+            int tail = (server->queue_head + server->queue_count) % SERVE_MAX_CONNECTIONS;
+            server->queue[tail] = (serve_pending_t) { .fd = server->idle[i], .ready_ns = ready_ns };
+            server->queue_count++;
+            queued++;
+        } else {
+            server->idle[kept++] = server->idle[i];
+        }
+    }
+    server->num_idle = kept;
+    while (server->num_returned > 0) {
+        server->idle[server->num_idle++] = server->returned[--server->num_returned];
+    }
+    if (queued > 0) {
+        pthread_cond_broadcast(&server->ready);
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    if (server->fds[0].revents & POLLIN) {
+        serve_accept(server);
+    }
+}
+
+// Long-running solver: a fixed set of worker threads, each with its own
+// OpenMP team and buffers, serves requests until SIGINT or SIGTERM. Every
+// request gets the configured phases, threads / workers threads and its own
+// time limit; per-request queueing and solve latencies are reported on exit.
+int run_server(const serve_options_t* options, const solver_config_t* config) {
+    server_t* server = calloc(1, sizeof(server_t));
+    serve_worker_t* workers = calloc((size_t)options->num_workers, sizeof(serve_worker_t));
+    if (!server || !workers) {
+        fprintf(stderr, "Error: Out of memory\n");
+        free(server);
+        free(workers);
+        return -1;
+    }
+    server->options = options;
+    server->config = config;
+    server->threads_per_request = options->mode == MODE_SEQUENTIAL ? 1 : config->num_threads / options->num_workers;
+    server->threads_per_request = server->threads_per_request > 0 ? server->threads_per_request : 1;
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->ready, NULL);
+
+    server->listen_fd = serve_listen(options->socket_path);
+    if (server->listen_fd < 0) {
+        free(server);
+        free(workers);
+        return -1;
+    }
+    if (pipe(server->wake) < 0 || fcntl(server->wake[0], F_SETFL, O_NONBLOCK) < 0
+        || fcntl(server->wake[1], F_SETFL, O_NONBLOCK) < 0) {
+        fprintf(stderr, "Error: Cannot create pipe: %s\n", strerror(errno));
+        close(server->listen_fd);
+        unlink(options->socket_path);
+        free(server);
+        free(workers);
+        return -1;
+    }
+
+    // Workers and their teams inherit a blocked mask, so signals reach the poll loop
+    serve_wake_fd = server->wake[1];
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = serve_handle_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN); // Clients that leave early fail their write instead
+
+    int started = 0;
+    for (; started < options->num_workers; started++) {
+        serve_worker_t* worker = &workers[started];
+        worker->server = server;
+        arena_init(&worker->arena, 0);
+        worker->buffer = malloc(SERVE_BUFFER_SIZE);
+        worker->capacity = worker->buffer ? SERVE_BUFFER_SIZE : 0;
+        if (pthread_create(&worker->thread, NULL, serve_worker_main, worker) != 0) {
+            fprintf(stderr, "Error: Cannot start worker thread\n");
+            arena_destroy(&worker->arena);
+            free(worker->buffer);
+            break;
+        }
+    }
+    pthread_sigmask(SIG_UNBLOCK, &stop_signals, NULL);
+
+    if (started == options->num_workers) {
+        printf("Serving:\t %s (%d workers, %d threads each)\n", options->socket_path, options->num_workers,
+            server->threads_per_request);
+        fflush(stdout);
+        while (!serve_stop) {
+            serve_poll(server);
+        }
+    }
+
+    pthread_mutex_lock(&server->lock);
+    server->stopping = 1;
+    pthread_cond_broadcast(&server->ready);
+    pthread_mutex_unlock(&server->lock);
+    for (int w = 0; w < started; w++) {
+        pthread_join(workers[w].thread, NULL);
+        arena_destroy(&workers[w].arena);
+        free(workers[w].buffer);
+    }
+    for (int i = 0; i < server->num_idle; i++) {
+        close(server->idle[i]);
+    }
+    for (int i = 0; i < server->num_returned; i++) {
+        close(server->returned[i]);
+    }
+    close(server->listen_fd);
+    close(server->wake[0]);
+    close(server->wake[1]);
+    unlink(options->socket_path);
+
+    int status = started == options->num_workers ? 0 : -1;
+    if (status == 0) {
+        printf("Requests:\t %ld (%ld failed)\n", server->requests, server->failures);
+        latency_report(&server->queued, "Queued", stdout);
+        latency_report(&server->solved, "Solved", stdout);
+    }
+    pthread_mutex_destroy(&server->lock);
+    pthread_cond_destroy(&server->ready);
+    free(server);
+    free(workers);
+    return status;
+}
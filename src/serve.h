@@ -0,0 +1,25 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+#include "jobshop.h"
+
+#define SERVE_MAX_CONNECTIONS 1024 // Open client connections, idle, queued or in service
+#define SERVE_MAX_REQUEST (1u << 30) // Bytes per instance
+#define SERVE_BUFFER_SIZE (1 << 16) // Initial receive buffer per worker
+#define SERVE_BACKLOG 64
+#define SERVE_RECEIVE_TIMEOUT 10 // Seconds from a request's first byte until it must be complete
+#define MAX_SERVE_WORKERS 1024
+
+// A request is one instance on a Unix stream socket: either text, ended by
+// the client shutting down its write side, or a .jssb image, which carries
+// its own length so any number can follow on one connection
+typedef struct {
+    const char* socket_path;
+    execution_mode_t mode;
+    int num_workers; // Requests solved concurrently
+    double time_limit; // Per request, 0 when unlimited
+} serve_options_t;
+
+int run_server(const serve_options_t* options, const solver_config_t* config);
+
+#endif
@@ -0,0 +1,229 @@
+#include "tabu.h"
+#include "anytime.h"
+#include "arena.h"
+#include "graph.h"
+#include "jobshop.h"
+#include "rng.h"
+#include "utils.h"
+#include <limits.h>
+#include <omp.h>
+#include <stdlib.h>
+
+#define TABU_TENURE_MIN 8
+#define TABU_TENURE_RANGE 8
+#define TABU_LIST_SIZE (TABU_TENURE_MIN + TABU_TENURE_RANGE)
+#define TABU_STALL_LIMIT 2000 // Non-improving iterations before returning to the best
+#define TABU_PARALLEL_MIN_MOVES 64 // Below this, fork/join costs more than evaluation
+#define TABU_STREAM 0x7ab0
+
+typedef struct {
+    int u; // Precedes v on their machine before the move
+    int v;
+    int estimate;
+} tabu_move_t;
+
+typedef struct {
+    int first;
+    int second;
+    long expires;
+} tabu_entry_t;
+
+typedef struct {
+    schedule_graph_t graph;
+    int* path;
+    int* via_machine; // via_machine[i]: path[i - 1] -> path[i] is a machine arc
+    tabu_move_t* moves;
+    tabu_entry_t entries[TABU_LIST_SIZE];
+    int next_entry;
+} tabu_state_t;
+
+static inline int is_critical(const schedule_graph_t* graph, const jobshop_t* jss, int op) {
+    return graph->heads[op] + jss->times[op] + graph->tails[op] == graph->makespan;
+}
+
+// One critical path, preferring machine arcs so blocks are as long as possible
+static int critical_path(tabu_state_t* state, const jobshop_t* jss) {
+    const schedule_graph_t* graph = &state->graph;
+    int op = -1;
+    for (int i = 0; i < graph->num_operations; i++) {
+        if (graph->heads[i] == 0 && is_critical(graph, jss, i)) {
+            op = i;
+            break;
+        }
+    }
+
+    int length = 0;
+    while (op >= 0) {
+        state->path[length++] = op;
+        int end = graph->heads[op] + jss->times[op];
+        int machine_succ = graph->machine_next[op];
+        int job_succ = graph_job_next(graph, jss, op);
+        if (machine_succ >= 0 && graph->heads[machine_succ] == end && is_critical(graph, jss, machine_succ)) {
+            state->via_machine[length] = 1;
+            op = machine_succ;
+        } else if (job_succ >= 0 && graph->heads[job_succ] == end && is_critical(graph, jss, job_succ)) {
+            state->via_machine[length] = 0;
+            op = job_succ;
+        } else {
+            op = -1;
+        }
+    }
+    return length;
+}
+
+static void add_move(tabu_state_t* state, const schedule_graph_t* graph, int* count, int u, int v) {
+    if (graph->job_of[u] == graph->job_of[v]) {
+        return;
+    }
+    if (*count > 0 && state->moves[*count - 1].u == u && state->moves[*count - 1].v == v) {
+        return;
+    }
+    state->moves[*count].u = u;
+    state->moves[*count].v = v;
+    (*count)++;
+}
+
+// N5: swap the first two and the last two operations of every critical block,
+// except at the start of the first block and the end of the last one
+static int collect_moves(tabu_state_t* state, const jobshop_t* jss) {
+    int length = critical_path(state, jss);
+    int count = 0;
+    int block_start = 0;
+
+    for (int i = 1; i <= length; i++) {
+        if (i < length && state->via_machine[i]) {
+            continue;
+        }
+        int block_end = i - 1;
+        if (block_end > block_start) {
+            int first_block = block_start == 0;
+            int last_block = i == length;
+            if (!first_block) {
+                add_move(state, &state->graph, &count, state->path[block_start], state->path[block_start + 1]);
+            }
+            if (!last_block) {
+                add_move(state, &state->graph, &count, state->path[block_end - 1], state->path[block_end]);
+            }
+        }
+        block_start = i;
+    }
+    return count;
+}
+
+static inline int finish_time(const schedule_graph_t* graph, const jobshop_t* jss, int op) {
+    return op >= 0 ? graph->heads[op] + jss->times[op] : 0;
+}
+
+static inline int tail_time(const schedule_graph_t* graph, const jobshop_t* jss, int op) {
+    return op >= 0 ? jss->times[op] + graph->tails[op] : 0;
+}
+
+// Makespan estimate after swapping u -> v, from the heads and tails of their
+// neighbours only: new heads forward through v then u, new tails backward
+// through u then v
+static int evaluate_move(const schedule_graph_t* graph, const jobshop_t* jss, int u, int v) {
+    int head_v = max(finish_time(graph, jss, graph_job_prev(graph, jss, v)),
+        finish_time(graph, jss, graph->machine_prev[u]));
+    int head_u = max(finish_time(graph, jss, graph_job_prev(graph, jss, u)), head_v + jss->times[v]);
+    int tail_u = max(tail_time(graph, jss, graph_job_next(graph, jss, u)),
+        tail_time(graph, jss, graph->machine_next[v]));
+    int tail_v = max(tail_time(graph, jss, graph_job_next(graph, jss, v)), tail_u + jss->times[u]);
+    return max(head_v + jss->times[v] + tail_v, head_u + jss->times[u] + tail_u);
+}
+
+static int is_tabu(const tabu_state_t* state, int u, int v, long iteration) {
+    for (int i = 0; i < TABU_LIST_SIZE; i++) {
+        const tabu_entry_t* entry = &state->entries[i];
+        if (entry->expires > iteration && entry->first == u && entry->second == v) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Improves solution in place with a tabu search over the N5 neighbourhood.
+// Returns the resulting makespan, or -1 on allocation failure.
+int tabu_search(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config) {
+    arena_t arena;
+    arena_init(&arena, 0);
+    tabu_state_t state = { .next_entry = 0 };
+    size_t n = (size_t)jss->num_operations;
+    state.path = arena_alloc(&arena, n * sizeof(int));
+    state.via_machine = arena_alloc(&arena, (n + 1) * sizeof(int));
+    state.moves = arena_alloc(&arena, n * sizeof(tabu_move_t));
+    if (graph_init(&state.graph, &arena, jss) < 0 || !state.path || !state.via_machine || !state.moves
+        || graph_from_solution(&state.graph, jss, solution) < 0 || graph_evaluate(&state.graph, jss) < 0) {
+        arena_destroy(&arena);
+        return -1;
+    }
+    for (int i = 0; i < TABU_LIST_SIZE; i++) {
+        state.entries[i].expires = -1;
+    }
+
+    rng_t rng;
+    rng_seed(&rng, config->seed, TABU_STREAM);
+    int parallel = config->tabu_parallel && config->num_threads > 1;
+    int best_makespan = state.graph.makespan;
+    graph_to_solution(&state.graph, jss, solution);
+    long stall = 0;
+
+    for (long iteration = 0; iteration < config->tabu_iterations; iteration++) {
+        if (anytime_expired(config->anytime)) {
+            break;
+        }
+        int count = collect_moves(&state, jss);
+        if (count == 0) {
+            break; // A single critical block: the makespan is a machine load, so optimal
+        }
+
+#pragma omp parallel for num_threads(config->num_threads) if (parallel && count >= TABU_PARALLEL_MIN_MOVES) schedule(static)
+        for (int i = 0; i < count; i++) {
+            state.moves[i].estimate = evaluate_move(&state.graph, jss, state.moves[i].u, state.moves[i].v);
+        }
+
+        // Best admissible move, tabu moves allowed when they beat the best (aspiration)
+        int chosen = -1;
+        for (int i = 0; i < count; i++) {
+            const tabu_move_t* move = &state.moves[i];
+            if (is_tabu(&state, move->u, move->v, iteration) && move->estimate >= best_makespan) {
+                continue;
+            }
+            if (chosen < 0 || move->estimate < state.moves[chosen].estimate) {
+                chosen = i;
+            }
+        }
+        if (chosen < 0) {
+            chosen = rng_below(&rng, count);
+        }
+
+        int u = state.moves[chosen].u;
+        int v = state.moves[chosen].v;
+        graph_swap_adjacent(&state.graph, jss, u, v);
+        if (graph_evaluate(&state.graph, jss) < 0) {
+            // Cannot happen for N5 moves, but never keep a cyclic sequencing
+            graph_swap_adjacent(&state.graph, jss, v, u);
+            graph_evaluate(&state.graph, jss);
+            break;
+        }
+
+        tabu_entry_t* entry = &state.entries[state.next_entry];
+        state.next_entry = (state.next_entry + 1) % TABU_LIST_SIZE;
+        entry->first = v;
+        entry->second = u;
+        entry->expires = iteration + TABU_TENURE_MIN + rng_below(&rng, TABU_TENURE_RANGE);
+
+        if (state.graph.makespan < best_makespan) {
+            best_makespan = state.graph.makespan;
+            graph_to_solution(&state.graph, jss, solution);
+            anytime_publish(config->anytime, best_makespan, "tabu");
+            stall = 0;
+        } else if (++stall >= TABU_STALL_LIMIT) {
+            graph_from_solution(&state.graph, jss, solution);
+            graph_evaluate(&state.graph, jss);
+            stall = 0;
+        }
+    }
+
+    arena_destroy(&arena);
+    return best_makespan;
+}
@@ -0,0 +1,8 @@
+#ifndef TABU_H
+#define TABU_H
+
+#include "jobshop.h"
+
+int tabu_search(const jobshop_t* jss, jobshop_solution_t* solution, const solver_config_t* config);
+
+#endif
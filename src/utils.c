@@ -1,83 +1,132 @@
+#define _POSIX_C_SOURCE 200809L
 #include "utils.h"
+#include "instance.h"
 #include "jobshop.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <omp.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 int calculate_remaining_work(const jobshop_t* jss, int job_id, int op_idx) {
-    int remaining_work = 0;
-    for (int i = op_idx; i < jss->num_machines; ++i) {
-        remaining_work += jss->times[job_id][i];
+    int idx = jss->job_offsets[job_id] + op_idx;
+    return idx < jss->job_offsets[job_id + 1] ? jss->remaining_work[idx] : 0;
+}
+
+// Returns the first job whose total time does not fit in an int, or -1
+int compute_remaining_work(jobshop_t* jss) {
+    for (int job = 0; job < jss->num_jobs; job++) {
+        long long remaining = 0;
+        for (int idx = jss->job_offsets[job + 1] - 1; idx >= jss->job_offsets[job]; idx--) {
+            remaining += jss->times[idx];
+            if (remaining > INT_MAX) {
+                return job;
+            }
+            jss->remaining_work[idx] = (int)remaining;
+        }
+    }
+    return -1;
+}
+
+#define FORK_JOIN_MAX_THREADS 256
+#define FORK_JOIN_SAMPLES 4
+
+// Cost of entering and leaving a parallel region of num_threads, measured
+// once per team size as the fastest of a few empty regions. Nested regions
+// run inactive and cost nothing.
+double fork_join_seconds(int num_threads) {
+    static double measured[FORK_JOIN_MAX_THREADS + 1];
+    if (num_threads <= 1 || omp_in_parallel()) {
+        return 0.0;
+    }
+    if (num_threads > FORK_JOIN_MAX_THREADS) {
+        num_threads = FORK_JOIN_MAX_THREADS;
+    }
+    double seconds;
+    __atomic_load(&measured[num_threads], &seconds, __ATOMIC_RELAXED);
+    if (seconds > 0.0) {
+        return seconds;
+    }
+
+    seconds = HUGE_VAL;
+    for (int sample = 0; sample < FORK_JOIN_SAMPLES; sample++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+#pragma omp parallel num_threads(num_threads)
+        {
+            __asm__ __volatile__("" ::: "memory");
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double elapsed = get_time_diff(start, end);
+        seconds = elapsed < seconds ? elapsed : seconds;
     }
-    return remaining_work;
+    seconds = seconds > 1e-9 ? seconds : 1e-9;
+    __atomic_store(&measured[num_threads], &seconds, __ATOMIC_RELAXED);
+    return seconds;
+}
+
+// Team size for num_tasks independent tasks of about task_seconds each: the
+// fewest threads reaching the shortest round count, or 1 when the measured
+// fork/join cost outweighs what they save. This is the crossover that keeps
+// small instances serial. Threads beyond the cores only add switching.
+int get_optimal_thread_count(int num_tasks, double task_seconds, int max_threads) {
+    int limit = num_tasks < max_threads ? num_tasks : max_threads;
+    limit = limit < omp_get_num_procs() ? limit : omp_get_num_procs();
+    if (limit <= 1) {
+        return 1;
+    }
+    int rounds = (num_tasks + limit - 1) / limit;
+    int threads = (num_tasks + rounds - 1) / rounds;
+    double serial = num_tasks * task_seconds;
+    double parallel = rounds * task_seconds + fork_join_seconds(threads);
+    return parallel < serial ? threads : 1;
 }
 
 double get_time_diff(struct timespec start, struct timespec end) {
     return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
 }
 
-int read_jobshop_from_file(const char* filename, jobshop_t* jss) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
+// Maps the file and picks the parser by content: .jssb binaries are used in
+// place, text is tokenized straight from the mapping without line buffers
+int read_jobshop_from_file(const char* filename, jobshop_t* jss, arena_t* arena) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
         fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
         return -1;
     }
-
-    char line[MAX_LINE_LENGTH];
-    int line_num = 0;
-
-    while (fgets(line, sizeof(line), file)) {
-        line_num++;
-        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
-            continue;
-        }
-
-        if (sscanf(line, "%d %d", &jss->num_jobs, &jss->num_machines) == 2) {
-            break;
-        }
+    struct stat info;
+    if (fstat(fd, &info) < 0 || info.st_size == 0) {
+        fprintf(stderr, "Error: Cannot read file '%s'\n", filename);
+        close(fd);
+        return -1;
     }
-
-    if (jss->num_jobs <= 0 || jss->num_machines <= 0 || jss->num_jobs > MAX_JOBS || jss->num_machines > MAX_MACHINES) {
-        fprintf(stderr, "Error: Invalid number of jobs (%d) or machines (%d)\n",
-            jss->num_jobs, jss->num_machines);
-        fclose(file);
+    size_t length = (size_t)info.st_size;
+    void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map file '%s'\n", filename);
         return -1;
     }
 
-    for (int job = 0; job < jss->num_jobs; job++) {
-        if (!fgets(line, sizeof(line), file)) {
-            fprintf(stderr, "Error: Unexpected end of file at job %d\n", job);
-            fclose(file);
+    if (length >= 4 && memcmp(data, JSSB_MAGIC, 4) == 0) {
+        if (load_jobshop_binary(data, length, filename, jss, arena) < 0 || arena_adopt_mapping(arena, data, length) < 0) {
+            munmap(data, length);
             return -1;
         }
-
-        char* token = strtok(line, " \t\n\r");
-        for (int op = 0; op < jss->num_machines; op++) {
-            if (!token) {
-                fprintf(stderr,
-                    "Error: Missing machine for job %d, operation %d\n",
-                    job, op);
-                fclose(file);
-                return -1;
-            }
-            jss->machines[job][op] = atoi(token);
-
-            token = strtok(NULL, " \t\n\r");
-            if (!token) {
-                fprintf(stderr,
-                    "Error: Missing time for job %d, operation %d\n", job,
-                    op);
-                fclose(file);
-                return -1;
-            }
-            jss->times[job][op] = atoi(token);
-            token = strtok(NULL, " \t\n\r");
-        }
+        return 0;
     }
 
-    fclose(file);
-    return 0;
+    posix_madvise(data, length, POSIX_MADV_SEQUENTIAL);
+    int result = parse_jobshop_text(data, length, filename, jss, arena);
+    munmap(data, length);
+    return result;
 }
 
 void print_jobshop_instance(const jobshop_t* jss) {
@@ -90,32 +139,35 @@ void print_jobshop_instance(const jobshop_t* jss) {
     for (int job = 0; job < jss->num_jobs; job++) {
         printf("Job %d: ", job);
         for (int op = 0; op < jss->num_machines; op++) {
-            printf("M(%d,%d) ", jss->machines[job][op], jss->times[job][op]);
+            printf("M(%d,%d) ", jobshop_machine(jss, job, op), jobshop_time(jss, job, op));
         }
         printf("\n");
     }
     printf("\n");
 }
 
-int write_jobshop_solution_to_file(const char* filename, const jobshop_solution_t* solution) {
-    FILE* file = fopen(filename, "w");
-    if (!file) {
-        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
-        return -1;
-    }
-
+// The makespan, then one line of operation start times per job
+void write_jobshop_solution(FILE* file, const jobshop_solution_t* solution) {
     fprintf(file, "%d\n", solution->makespan);
 
     for (int job = 0; job < solution->num_jobs; job++) {
         for (int op = 0; op < solution->num_machines; op++) {
-            fprintf(file, "%d", solution->schedule[job][op].start_time);
+            fprintf(file, "%d", solution_op_const(solution, job, op)->start_time);
             if (op < solution->num_machines - 1) {
                 fprintf(file, "  ");
             }
         }
         fprintf(file, "\n");
     }
+}
 
+int write_jobshop_solution_to_file(const char* filename, const jobshop_solution_t* solution) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open file '%s' for writing\n", filename);
+        return -1;
+    }
+    write_jobshop_solution(file, solution);
     fclose(file);
     return 0;
 }
@@ -128,11 +180,53 @@ void print_jobshop_solution(const jobshop_solution_t* solution) {
     for (int job = 0; job < solution->num_jobs; job++) {
         printf("Job %d: ", job);
         for (int op = 0; op < solution->num_machines; op++) {
-            printf("M(%d,%d) %d  ", solution->schedule[job][op].machine_id,
-                solution->schedule[job][op].end_time - solution->schedule[job][op].start_time,
-                solution->schedule[job][op].start_time);
+            const operation_schedule_t* scheduled = solution_op_const(solution, job, op);
+            printf("M(%d,%d) %d  ", scheduled->machine_id,
+                scheduled->end_time - scheduled->start_time,
+                scheduled->start_time);
         }
         printf("\n");
     }
     printf("\n");
 }
+
+// Zeroed array starting on a cache line, released with free()
+void* cache_aligned_calloc(size_t count, size_t size) {
+    void* memory;
+    if (count > 0 && size > SIZE_MAX / count) {
+        return NULL;
+    }
+    if (posix_memalign(&memory, CACHE_LINE_SIZE, count * size) != 0) {
+        return NULL;
+    }
+    memset(memory, 0, count * size);
+    return memory;
+}
+
+void print_json_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        unsigned char byte = (unsigned char)*c;
+        if (byte < 0x20) {
+            fprintf(file, "\\u%04x", byte); // Control characters must be escaped
+            continue;
+        }
+        if (byte == '"' || byte == '\\') {
+            fputc('\\', file);
+        }
+        fputc(byte, file);
+    }
+    fputc('"', file);
+}
+
+// RFC 4180 field: always quoted, embedded quotes doubled
+void print_csv_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"') {
+            fputc('"', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
@@ -1,18 +1,29 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdio.h>
 #include <time.h>
 
+#include "arena.h"
 #include "jobshop.h"
 
+// Per-thread slots written in parallel are padded and aligned to this
+#define CACHE_LINE_SIZE 64
+
 double get_time_diff(struct timespec start, struct timespec end);
-int read_jobshop_from_file(const char* filename, jobshop_t* jss);
+int read_jobshop_from_file(const char* filename, jobshop_t* jss, arena_t* arena);
 void print_jobshop_instance(const jobshop_t* jss);
+void write_jobshop_solution(FILE* file, const jobshop_solution_t* solution);
 int write_jobshop_solution_to_file(const char* filename, const jobshop_solution_t* solution);
 void print_jobshop_solution(const jobshop_solution_t* solution);
+void print_json_string(FILE* file, const char* text);
+void print_csv_string(FILE* file, const char* text);
+void* cache_aligned_calloc(size_t count, size_t size);
 
 int calculate_remaining_work(const jobshop_t* jss, int job_id, int op_idx);
-int get_optimal_thread_count();
+int compute_remaining_work(jobshop_t* jss);
+double fork_join_seconds(int num_threads);
+int get_optimal_thread_count(int num_tasks, double task_seconds, int max_threads);
 
 static inline int max(int a, int b) {
     return (a > b) ? a : b;